@@ -0,0 +1,171 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              account.h
+
+DESCRIPTION:       The Account record, shared between the user interface and the database code
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __ACCOUNT_H__
+#define __ACCOUNT_H__
+
+#define FIRST_NAME_LENGTH 50
+#define LAST_NAME_LENGTH 50
+#define ACC_NUM_LENGTH 5
+#define PASS_LENGTH 6
+
+#include <stdint.h>
+#include <cstdio>
+
+//Account numbers are ACC_NUM_LENGTH characters from 0-9 and A-Z, so they can be read as a base 36 number.
+//36^5 fits in 26 bits, and because digits come before letters the keys sort the same way the strings do
+typedef uint32_t AccKey;
+#define ACC_KEY_INVALID 0xFFFFFFFFu
+//How many account numbers there are, 36^ACC_NUM_LENGTH
+#define ACC_KEY_COUNT 60466176u
+
+//Money is kept as a whole number of cents, so adding it up never drifts
+typedef int64_t Cents;
+#define CENTS_PER_DOLLAR 100
+//Room for any Cents written by formatCents(), with its '\0'
+#define CENTS_LENGTH 24
+//parseCents() takes at most this many digits, which keeps the dollars well inside a Cents
+#define CENTS_MAX_DIGITS 15
+//...and nothing as big as this many cents, even with an exponent
+#define CENTS_MAX 100000000000000000ll
+
+//Account is plain old data so that it can be written to and mapped from the binary database as-is
+//If you change it, bump DB_VERSION in database.h
+struct Account {
+	char first[FIRST_NAME_LENGTH + 1];
+	char last[LAST_NAME_LENGTH + 1];
+	char middle;
+	unsigned int social;
+	unsigned int area;
+	unsigned int phone;
+	Cents balance;
+	char number[ACC_NUM_LENGTH + 1];
+	char password[PASS_LENGTH + 1];
+	//number packed into an integer, for comparing, sorting and hashing
+	AccKey key;
+	//Length of full name (including two spaces and a .)
+	unsigned int nameLength;
+};
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          packAccNum()
+DESCRIPTION:       Packs an account number into an AccKey. Lower case letters count as upper case.
+                   A number shorter than ACC_NUM_LENGTH is packed as if it were padded with 0s,
+                   which gives the smallest key that starts with it
+RETURNS:           The key, or ACC_KEY_INVALID if number has characters that can't be in an account number
+----------------------------------------------------------------------------- */
+inline AccKey packAccNum(const char* number) {
+	AccKey key = 0;
+	bool ended = false;
+	for(int i = 0; i < ACC_NUM_LENGTH; i++) {
+		char c = ended ? '\0' : number[i];
+		unsigned int digit;
+		if(!c) {
+			ended = true;
+			digit = 0;
+		} else if(c >= '0' && c <= '9') digit = c - '0';
+		else if(c >= 'A' && c <= 'Z') digit = c - 'A' + 10;
+		else if(c >= 'a' && c <= 'z') digit = c - 'a' + 10;
+		else return ACC_KEY_INVALID;
+		key = key * 36 + digit;
+	}
+	if(!ended && number[ACC_NUM_LENGTH]) return ACC_KEY_INVALID;
+	return key;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          unpackAccNum()
+DESCRIPTION:       Turns an AccKey back into an account number
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+inline void unpackAccNum(AccKey key, char* number) {
+	for(int i = ACC_NUM_LENGTH - 1; i >= 0; i--) {
+		unsigned int digit = key % 36;
+		number[i] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		key /= 36;
+	}
+	number[ACC_NUM_LENGTH] = '\0';
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parseCents()
+DESCRIPTION:       Reads an amount like -1234.56 from the characters between text and end.
+                   It can have an exponent, like 1.23457e+06, which is how the first version of bankacct
+                   saved any balance of a million dollars or more
+RETURNS:           true if it was an amount, false otherwise
+NOTES:             Anything past the cents is rounded, half away from zero
+----------------------------------------------------------------------------- */
+inline bool parseCents(const char* text, const char* end, Cents* value) {
+	bool negative = text < end && *text == '-';
+	if(negative) text++;
+
+	//Every digit goes into mantissa, and the exponent and the decimals say where the cents are in it
+	unsigned long long mantissa = 0;
+	int digits = 0, decimals = -1;
+	for(; text < end && *text != 'e' && *text != 'E'; text++) {
+		if(*text == '.' && decimals < 0) {
+			decimals = 0;
+			continue;
+		}
+		unsigned int digit = (unsigned char) *text - '0';
+		if(digit > 9 || ++digits > CENTS_MAX_DIGITS) return false;
+		mantissa = mantissa * 10 + digit;
+		if(decimals >= 0) decimals++;
+	}
+	if(!digits) return false;
+
+	int exponent = 0;
+	if(text < end) {
+		bool down = ++text < end && *text == '-';
+		if(text < end && (*text == '-' || *text == '+')) text++;
+		if(text == end || end - text > 3) return false;
+		for(; text < end; text++) {
+			unsigned int digit = (unsigned char) *text - '0';
+			if(digit > 9) return false;
+			exponent = exponent * 10 + digit;
+		}
+		if(down) exponent = -exponent;
+	}
+
+	int shift = exponent - (decimals < 0 ? 0 : decimals) + 2;
+	Cents result;
+	if(shift >= 0) {
+		//No more dollars than CENTS_MAX_DIGITS digits of them, the same as without an exponent
+		result = mantissa;
+		for(; shift > 0; shift--) {
+			if(result >= CENTS_MAX / 10) return false;
+			result *= 10;
+		}
+		if(result >= CENTS_MAX) return false;
+	} else if(shift < -19) result = 0; //mantissa is less than half of 10^19
+	else {
+		unsigned long long scale = 1;
+		for(; shift < 0; shift++) scale *= 10;
+		result = mantissa / scale;
+		if(mantissa % scale * 2 >= scale) result++;
+	}
+	*value = negative ? -result : result;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          formatCents()
+DESCRIPTION:       Writes an amount out as dollars and cents, like -1234.56
+RETURNS:           text, which needs room for CENTS_LENGTH characters
+----------------------------------------------------------------------------- */
+inline char* formatCents(Cents value, char* text) {
+	//Work with the size of it, so that the most negative value doesn't overflow
+	unsigned long long size = value < 0 ? 0 - (unsigned long long) value : value;
+	snprintf(text, CENTS_LENGTH, "%s%llu.%02llu", value < 0 ? "-" : "",
+		size / CENTS_PER_DOLLAR, size % CENTS_PER_DOLLAR);
+	return text;
+}
+
+#endif
@@ -0,0 +1,636 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              accountstore.cpp
+	DESCRIPTION:       The account store. Loads a database file and brings back its journal,
+	                   keeps the index up to date as accounts come and go, and saves it all again.
+	                   Binary databases are saved in place, a slot at a time
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <fstream>
+#include <algorithm>
+#include <unordered_set>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "accountstore.h"
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::load()
+DESCRIPTION:       Reads the database file name and sorts it by account number
+RETURNS:           true if it was read, false otherwise
+NOTES:             Both text and binary database files are accepted. It's saved in the format it was read in.
+                   Large text files are parsed on up to threads threads.
+                   If the index file saved with it is still good, the index and orders come from that, nothing
+                   is sorted, and a binary file is read straight into number order without interning any names.
+                   Call openJournal() next, before looking anything up or changing anything
+----------------------------------------------------------------------------- */
+bool AccountStore::load(const char* name, unsigned int threads, char* error) {
+	if(!beginLoad(name, threads, error)) return false;
+	while(!reader.finished()) {
+		if(!readBatch(SIZE_MAX, error)) {
+			reader.close();
+			saved.close();
+			state = LOAD_BAD_DATABASE;
+			return false;
+		}
+	}
+	endLoad();
+	state = LOAD_DONE;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::startLoad()
+DESCRIPTION:       Does what load() and then openJournal() do, on a thread of its own, so the accounts can be
+                   looked at as they come in. loadState() says how it's going
+RETURNS:           true if it's started, false if the database file can't be opened
+NOTES:             It's read STORE_LOAD_BATCH accounts at a time, in the order they're in the file, and only
+                   sorted once it's all in. The sync policy has to be set before this. Until it's done, the table has to be locked with lockTable() to look at it,
+                   and anything else that looks at the accounts or changes them has to wait
+----------------------------------------------------------------------------- */
+bool AccountStore::startLoad(const char* name, unsigned int threads, char* error) {
+	if(!beginLoad(name, threads, error)) return false;
+	state = LOAD_RUNNING;
+	loader = thread(&AccountStore::loadLoop, this);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::stopLoad()
+DESCRIPTION:       Stops startLoad()'s thread, if it's still reading, and waits for it
+RETURNS:           Void function
+NOTES:             If it's got as far as sorting or the journal, that's finished first, and it's LOAD_DONE.
+                   Otherwise it's LOAD_NONE, and what was read so far is thrown away. Don't hold lockTable()
+----------------------------------------------------------------------------- */
+void AccountStore::stopLoad() {
+	if(!loader.joinable()) return;
+	cancelLoad = true;
+	loader.join();
+	cancelLoad = false;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::lockTable()
+DESCRIPTION:       Waits until startLoad()'s thread is between batches and keeps it there
+RETURNS:           The lock. The table can be looked at until it's let go of
+----------------------------------------------------------------------------- */
+unique_lock<mutex> AccountStore::lockTable() {
+	tableWanted++;
+	unique_lock<mutex> guard(tableLock);
+	tableWanted--;
+	return guard;
+}
+
+//Everything load() and startLoad() do before reading any accounts
+bool AccountStore::beginLoad(const char* name, unsigned int threads, char* error) {
+	stopLoad();
+	stopCheckpoints();
+	state = LOAD_NONE;
+	loaded = 0;
+	fileName = name;
+	this->threads = threads;
+	people.clear();
+	clearOrders();
+	slots.clear();
+	slotRows.clear();
+	freeSlots.clear();
+	generation = 0;
+	slotsSaved = false;
+	indexSaved = false;
+	saved.close();
+	if(!reader.open(name, error)) return false;
+	format = reader.fileFormat();
+	//The index file, if it goes with the database file as it is now, has the indexes built already.
+	//A binary file is read straight into number order with it, names and all
+	haveIndexes = saved.open(name);
+	if(haveIndexes && format == DB_BINARY && !saved.prepare(&people, &reader)) haveIndexes = false;
+	return true;
+}
+
+//Reads about count more accounts into the table
+bool AccountStore::readBatch(size_t count, char* error) {
+	if(reader.read(&people, format == DB_BINARY ? &slots : nullptr, count, threads, error)) return true;
+	if(!haveIndexes || format != DB_BINARY) return false;
+	//The index file doesn't fit the database file after all. Start again in slot order
+	haveIndexes = false;
+	people.clear();
+	slots.clear();
+	reader.setOrder(nullptr, nullptr, 0);
+	return true;
+}
+
+//Everything load() does once the accounts are all in: the slots, then the indexes and sorting
+void AccountStore::endLoad() {
+	if(format == DB_BINARY) {
+		generation = reader.generation();
+		slotRows.assign(reader.slotCount(), UINT32_MAX);
+		for(size_t row = 0; row < slots.size(); row++) slotRows[slots[row]] = row;
+		for(uint64_t slot = slotRows.size(); slot-- > 0;) {
+			if(slotRows[slot] == UINT32_MAX) freeSlots.push_back(slot);
+		}
+		slotsSaved = true;
+	}
+	reader.close();
+	indexSaved = haveIndexes && saved.rows() == people.size() && saved.restore(&index, orders);
+	saved.close();
+	vector<uint32_t> moved;
+	if(!indexSaved && people.sortByNumber(&moved)) moveSlots(moved);
+	clearDirty();
+	//The index and orders were saved with the old numbers, if they were saved at all
+	if(renumberDuplicates()) indexSaved = false;
+	loaded = 1000;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::renumberDuplicates()
+DESCRIPTION:       Gives every account whose number is the same as the one before it the next number up
+                   that nobody has
+RETURNS:           true if any account was renumbered, false otherwise
+NOTES:             The table has to be sorted by number. The journal finds accounts by number, so it can't
+                   tell two with the same one apart. The new numbers only depend on what's in the file,
+                   so a journal replayed after a crash finds the same accounts it was written against
+----------------------------------------------------------------------------- */
+bool AccountStore::renumberDuplicates() {
+	//Work them all out before changing any, so the table can still be searched
+	vector<pair<uint32_t, AccKey>> changes;
+	unordered_set<AccKey> given;
+	for(size_t row = 1; row < people.size(); row++) {
+		AccKey key = people.key(row);
+		if(key != people.key(row - 1)) continue;
+		//Stops going round if every number is taken, which leaves it as it was
+		do key = (key + 1) % ACC_KEY_COUNT;
+		while(key != people.key(row) && (people.find(key) >= 0 || given.count(key)));
+		given.insert(key);
+		changes.push_back(make_pair(row, key));
+	}
+	if(changes.empty()) return false;
+
+	for(const pair<uint32_t, AccKey>& change : changes) {
+		people.setNumber(change.first, change.second);
+		markRow(change.first);
+	}
+	vector<uint32_t> moved;
+	if(people.sortByNumber(&moved)) moveSlots(moved);
+	return true;
+}
+
+//startLoad()'s thread. A batch at a time, then everything else load() and openJournal() do in one go
+void AccountStore::loadLoop() {
+	while(true) {
+		//Anything waiting for the table gets it before the next batch
+		while(tableWanted) this_thread::yield();
+		lock_guard<mutex> guard(tableLock);
+		if(cancelLoad) {
+			reader.close();
+			saved.close();
+			people.clear();
+			slots.clear();
+			state = LOAD_NONE;
+			return;
+		}
+		if(reader.finished()) {
+			endLoad();
+			state = openJournal(loadMessage) ? LOAD_DONE : LOAD_BAD_JOURNAL;
+			return;
+		}
+		if(!readBatch(STORE_LOAD_BATCH, loadMessage)) {
+			reader.close();
+			saved.close();
+			state = LOAD_BAD_DATABASE;
+			return;
+		}
+		loaded = reader.progress();
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::openJournal()
+DESCRIPTION:       Replays any changes which were made after the database file was last saved,
+                   then starts logging new ones
+RETURNS:           true if the journal is open, false otherwise
+NOTES:             The sync policy has to be set before this
+----------------------------------------------------------------------------- */
+bool AccountStore::openJournal(char* error) {
+	if(!journal.open(fileName.c_str(), &people, error)) return false;
+	//Replaying moves rows around, and the files don't have what was replayed. Start the slots
+	//and the indexes again
+	if(journal.mark()) {
+		freshSlots();
+		indexSaved = false;
+	}
+	if(!indexSaved) {
+		index.build(&people);
+		clearOrders();
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::save()
+DESCRIPTION:       Writes the accounts back to the database file. Once they're in it, the journal is emptied
+RETURNS:           true if it was saved, false otherwise
+NOTES:             If it couldn't be saved, the journal still has every change. Nothing is saved until
+                   the database has been loaded all the way.
+                   Accounts opened and closed since the last save leave the table out of order,
+                   so it's sorted by number again first, and the indexes are moved to the new rows.
+                   Accounts keep their slots in a binary file, so usually only the ones that changed are written
+----------------------------------------------------------------------------- */
+bool AccountStore::save() {
+	//Until it's all loaded, what's in memory isn't the whole database
+	if(state != LOAD_DONE) return false;
+	lock_guard<mutex> running(checkpointing);
+	vector<uint32_t> moved;
+	if(people.sortByNumber(&moved)) {
+		index.build(&people);
+		for(OrderIndex& order : orders) {
+			if(order.isBuilt()) order.renumber(moved);
+		}
+		moveSlots(moved);
+	}
+
+	bool saved = false;
+	if(format == DB_BINARY && slotsSaved) {
+		uint64_t changed = 0;
+		for(size_t word = 0; word < dirtyWords; word++) changed += __builtin_popcountll(dirty[word].load());
+		if(changed * STORE_REWRITE_SHARE <= slotRows.size()) saved = saveSlots();
+	}
+	if(!saved && !saveAll()) return false;
+	saveIndexes();
+	journal.reset(fileName.c_str());
+	return true;
+}
+
+//Brings the index file up to date with the database file that's just been written. It doesn't
+//matter if it can't be, apart from next time being slower to load
+void AccountStore::saveIndexes() {
+	if(indexSaved && restampIndexFile(fileName.c_str())) return;
+	//A binary file's slots go in it too, so it can be loaded in number order whatever order they're in
+	indexSaved = writeIndexFile(fileName.c_str(), people, format == DB_BINARY ? &slots : nullptr, index, orders);
+}
+
+//Writes the slots that have changed into the database file where it is, and moves it on a generation
+bool AccountStore::saveSlots() {
+	SlotWriter out;
+	if(!out.open(fileName.c_str())) return false;
+	Account free = Account();
+	free.key = ACC_KEY_INVALID;
+	for(size_t word = 0; word < dirtyWords; word++) {
+		uint64_t bits = dirty[word].load();
+		while(bits) {
+			uint32_t slot = word * 64 + __builtin_ctzll(bits);
+			bits &= bits - 1;
+			if(slotRows[slot] == UINT32_MAX) out.write(slot, free);
+			else out.write(slot, people.get(slotRows[slot]));
+		}
+	}
+	if(!out.commit(slotRows.size(), generation + 1)) return false;
+	generation++;
+	clearDirty();
+	return true;
+}
+
+//Writes a whole new database file. A binary one gets the accounts in number order with no free slots
+bool AccountStore::saveAll() {
+	if(format == DB_TEXT) return writeTextDatabase(fileName.c_str(), &people);
+	if(!writeBinaryDatabase(fileName.c_str(), &people, nullptr, people.size(), generation + 1)) return false;
+	generation++;
+	freshSlots();
+	slotsSaved = true;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::checkpoint()
+DESCRIPTION:       Saves the accounts as they are now without holding anything up, and cuts the journal
+                   down to the changes made since
+RETURNS:           true if the checkpoint was saved, or there was nothing to save, false otherwise
+NOTES:             A copy of the process is forked off to sort and write its copy of the accounts,
+                   which the kernel only really copies as either side changes it. Changes can carry on
+                   while it does. Once the new file is on disk it goes in place of the database file, and
+                   the journal is moved on top of it (see Journal::rebase()).
+                   If anything goes wrong, the database file and journal are left as they were
+----------------------------------------------------------------------------- */
+bool AccountStore::checkpoint() {
+	if(state != LOAD_DONE) return true;
+	lock_guard<mutex> running(checkpointing);
+	string snapshotName = fileName + STORE_CHECKPOINT_SUFFIX;
+	uint64_t mark;
+	bool indexCurrent;
+	pid_t child;
+	{
+		lock_guard<mutex> guard(structure);
+		//Changes logged after this are kept in the journal, even if they make it into the copy
+		mark = journal.mark();
+		if(!mark) return true;
+		//If the index file goes with the accounts as they are, it goes with the copy too
+		indexCurrent = indexSaved;
+		child = fork();
+		if(!child) {
+			//A binary file keeps the slots as they are, so saves after it can still be done in place.
+			//A text one is sorted, but only the copy. Rows here stay put
+			if(format == DB_BINARY) {
+				_exit(writeBinaryDatabase(snapshotName.c_str(), &people, &slots, slotRows.size(), generation + 1) ? 0 : 1);
+			}
+			people.sortByNumber(nullptr);
+			_exit(writeTextDatabase(snapshotName.c_str(), &people) ? 0 : 1);
+		}
+	}
+	if(child < 0) return false;
+
+	int status;
+	while(waitpid(child, &status, 0) < 0) {
+		if(errno != EINTR) return false;
+	}
+	if(!WIFEXITED(status) || WEXITSTATUS(status)) {
+		unlink(snapshotName.c_str());
+		return false;
+	}
+	if(!journal.rebase(fileName.c_str(), snapshotName.c_str(), mark)) {
+		unlink(snapshotName.c_str());
+		return false;
+	}
+	//Anything that changed after the fork is still marked, along with some that didn't need to be
+	if(format == DB_BINARY) {
+		generation++;
+		slotsSaved = true;
+	}
+	if(indexCurrent) restampIndexFile(fileName.c_str());
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::startCheckpoints(), stopCheckpoints()
+DESCRIPTION:       Start a thread which calls checkpoint() every seconds seconds, or stop it again.
+                   0 seconds means no checkpoints
+RETURNS:           Void functions
+NOTES:             Start it after openJournal() or startLoad(). There aren't any checkpoints until it's all
+                   loaded. Stopping waits for a checkpoint that's under way to finish
+----------------------------------------------------------------------------- */
+void AccountStore::startCheckpoints(unsigned int seconds) {
+	stopCheckpoints();
+	if(!seconds) return;
+	checkpointSecs = seconds;
+	checkpointer = thread(&AccountStore::checkpointLoop, this);
+}
+
+void AccountStore::stopCheckpoints() {
+	if(!checkpointer.joinable()) return;
+	{
+		lock_guard<mutex> guard(checkpointLock);
+		stopping = true;
+	}
+	checkpointWake.notify_one();
+	checkpointer.join();
+	stopping = false;
+}
+
+//The checkpoint thread. A checkpoint that fails is tried again next time, and until then the journal has it all
+void AccountStore::checkpointLoop() {
+	unique_lock<mutex> guard(checkpointLock);
+	while(!checkpointWake.wait_for(guard, chrono::seconds(checkpointSecs), [this]() { return stopping; })) {
+		guard.unlock();
+		checkpoint();
+		guard.lock();
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::deposit(), withdraw(), transfer()
+DESCRIPTION:       Move money in or out of the account at row, or between two accounts,
+                   keeping the balance order up to date if there is one
+RETURNS:           TX_OK if it was done, otherwise why not
+NOTES:             The accounts' slots are marked for the next save. TX_LOADING until loading is done
+----------------------------------------------------------------------------- */
+TxStatus AccountStore::deposit(unsigned int row, Cents amount) {
+	if(state != LOAD_DONE) return TX_LOADING;
+	Cents was = people.balance(row);
+	TxStatus status = applyDeposit(&people, &journal, row, amount);
+	if(status != TX_OK) return status;
+	markRow(row);
+	if(orders[ORDER_BALANCE].isBuilt()) orders[ORDER_BALANCE].balanceChanged(&people, row, was);
+	return TX_OK;
+}
+
+TxStatus AccountStore::withdraw(unsigned int row, Cents amount) {
+	if(state != LOAD_DONE) return TX_LOADING;
+	Cents was = people.balance(row);
+	TxStatus status = applyWithdraw(&people, &journal, row, amount);
+	if(status != TX_OK) return status;
+	markRow(row);
+	if(orders[ORDER_BALANCE].isBuilt()) orders[ORDER_BALANCE].balanceChanged(&people, row, was);
+	return TX_OK;
+}
+
+TxStatus AccountStore::transfer(unsigned int from, unsigned int to, Cents amount) {
+	if(state != LOAD_DONE) return TX_LOADING;
+	Cents fromWas = people.balance(from), toWas = people.balance(to);
+	TxStatus status = applyTransfer(&people, &journal, from, to, amount);
+	if(status != TX_OK) return status;
+	markRow(from);
+	markRow(to);
+	if(from != to && orders[ORDER_BALANCE].isBuilt()) {
+		//One account at a time. While from moves, to's old balance is put back,
+		//so everything else in the order still matches the table
+		Cents toNow = people.balance(to);
+		people.balance(to) = toWas;
+		orders[ORDER_BALANCE].balanceChanged(&people, from, fromWas);
+		people.balance(to) = toNow;
+		orders[ORDER_BALANCE].balanceChanged(&people, to, toWas);
+	}
+	return TX_OK;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::open(), close()
+DESCRIPTION:       Open a new account, or close the one at row, keeping any order indexes up to date
+RETURNS:           TX_OK if it was done, otherwise why not
+NOTES:             A new account goes in the first free slot, or a new one on the end.
+                   A closed account's slot is freed, and the account moved into its row keeps its own slot
+----------------------------------------------------------------------------- */
+TxStatus AccountStore::open(Account* acc) {
+	if(state != LOAD_DONE) return TX_LOADING;
+	lock_guard<mutex> guard(structure);
+	TxStatus status = applyOpen(&people, &index, &journal, acc);
+	if(status != TX_OK) return status;
+	indexSaved = false;
+	if(format == DB_BINARY) {
+		uint32_t slot;
+		if(freeSlots.empty()) {
+			slot = slotRows.size();
+			slotRows.push_back(0);
+			growDirty();
+		} else {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		slots.push_back(slot);
+		slotRows[slot] = people.size() - 1;
+		markSlot(slot);
+	}
+	for(OrderIndex& order : orders) {
+		if(order.isBuilt()) order.inserted(&people, people.size() - 1);
+	}
+	return TX_OK;
+}
+
+TxStatus AccountStore::close(unsigned int row) {
+	if(state != LOAD_DONE) return TX_LOADING;
+	lock_guard<mutex> guard(structure);
+	//The orders find the account by what's in its row, so it has to come out of them before it's gone
+	for(OrderIndex& order : orders) {
+		if(order.isBuilt()) order.erased(&people, row);
+	}
+	unsigned int last = people.size() - 1;
+	TxStatus status = applyClose(&people, &index, &journal, row);
+	if(status != TX_OK) {
+		for(OrderIndex& order : orders) {
+			if(order.isBuilt()) order.inserted(&people, row);
+		}
+		return status;
+	}
+	indexSaved = false;
+	if(format == DB_BINARY) {
+		uint32_t freed = slots[row];
+		slots[row] = slots[last];
+		slotRows[slots[row]] = row;
+		slots.pop_back();
+		slotRows[freed] = UINT32_MAX;
+		freeSlots.push_back(freed);
+		markSlot(freed);
+	}
+	//The last account was moved into row
+	if(row != last) {
+		for(OrderIndex& order : orders) {
+			if(order.isBuilt()) order.moved(&people, row, last);
+		}
+	}
+	return TX_OK;
+}
+
+//Unmarks every slot, making room for as many as there are
+void AccountStore::clearDirty() {
+	dirtyWords = slotRows.size() / 64 + 1;
+	dirty.reset(new atomic<uint64_t>[dirtyWords]);
+	for(size_t word = 0; word < dirtyWords; word++) dirty[word].store(0);
+}
+
+//Makes room for a slot that's just been added on the end, twice as much as is needed when there isn't enough
+void AccountStore::growDirty() {
+	size_t words = slotRows.size() / 64 + 1;
+	if(words <= dirtyWords) return;
+	words = max(words, dirtyWords * 2);
+	unique_ptr<atomic<uint64_t>[]> grown(new atomic<uint64_t>[words]);
+	for(size_t word = 0; word < words; word++) grown[word].store(word < dirtyWords ? dirty[word].load() : 0);
+	dirty.swap(grown);
+	dirtyWords = words;
+}
+
+//Puts row i in slot i, with no free slots. Nothing's marked, so the file has to be written whole next
+void AccountStore::freshSlots() {
+	if(format != DB_BINARY) return;
+	slots.resize(people.size());
+	for(size_t row = 0; row < slots.size(); row++) slots[row] = row;
+	slotRows = slots;
+	freeSlots.clear();
+	slotsSaved = false;
+	clearDirty();
+}
+
+//Moves each row's slot with it, after the table has been sorted. newRow is the new row of every old row
+void AccountStore::moveSlots(const vector<uint32_t>& newRow) {
+	if(format != DB_BINARY) return;
+	vector<uint32_t> was(slots);
+	for(size_t row = 0; row < was.size(); row++) {
+		slots[newRow[row]] = was[row];
+		slotRows[was[row]] = newRow[row];
+	}
+}
+
+void AccountStore::clearOrders() {
+	for(OrderIndex& order : orders) order.clear();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::order()
+DESCRIPTION:       Gets the accounts sorted by column
+RETURNS:           The order index
+NOTES:             The first time a column is asked for it's sorted, on as many threads as load() was given,
+                   which takes a moment on a big database. After that it's kept up to date as accounts
+                   are opened and closed and money moves, so switching between orders is instant
+----------------------------------------------------------------------------- */
+const OrderIndex& AccountStore::order(OrderColumn column) {
+	if(!orders[column].isBuilt()) {
+		orders[column].build(&people, column, threads);
+		lock_guard<mutex> guard(structure);
+		if(column != ORDER_BALANCE) indexSaved = false;
+	}
+	return orders[column];
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::findPrefix()
+DESCRIPTION:       Finds every account whose number, last name or first name starts with text, ignoring case
+RETURNS:           Void function. The matches go in matches, and matchRow() says which account each one is
+NOTES:             Only binary searches, so it can be done on every key pressed
+----------------------------------------------------------------------------- */
+void AccountStore::findPrefix(const char* text, FindMatches* matches) {
+	for(int kind = 0; kind < FIND_KINDS; kind++) matches->begin[kind] = matches->end[kind] = 0;
+	if(!*text) return;
+	order(ORDER_NUMBER).prefix(&people, text, &matches->begin[FIND_NUMBER], &matches->end[FIND_NUMBER]);
+	order(ORDER_NAME).prefix(&people, text, &matches->begin[FIND_NAME], &matches->end[FIND_NAME]);
+	order(ORDER_FIRST_NAME).prefix(&people, text, &matches->begin[FIND_FIRST_NAME], &matches->end[FIND_FIRST_NAME]);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::matchRow()
+DESCRIPTION:       Works out which account the i'th of some matches is. Number matches come first,
+                   then last names, then first names
+RETURNS:           The row of the account
+NOTES:             i has to be less than matches.count(), and nothing can have been opened or closed since
+----------------------------------------------------------------------------- */
+unsigned int AccountStore::matchRow(const FindMatches& matches, size_t i) const {
+	size_t numbers = matches.end[FIND_NUMBER] - matches.begin[FIND_NUMBER];
+	if(i < numbers) return orders[ORDER_NUMBER].row(matches.begin[FIND_NUMBER] + i);
+	i -= numbers;
+	size_t names = matches.end[FIND_NAME] - matches.begin[FIND_NAME];
+	if(i < names) return orders[ORDER_NAME].row(matches.begin[FIND_NAME] + i);
+	return orders[ORDER_FIRST_NAME].row(matches.begin[FIND_FIRST_NAME] + i - names);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountStore::report()
+DESCRIPTION:       Writes a legible report of every account in number order, and their total, to the file reportName
+RETURNS:           true if it was written, false otherwise
+----------------------------------------------------------------------------- */
+bool AccountStore::report(const char* reportName) {
+	ofstream file(reportName);
+	if(!file.is_open()) return false;
+	file << "-------  ----            -----           --  ---------  ------------  -------" << endl
+	     << "Account  Last            First           MI  SS         Phone         Account" << endl
+		 << "Number   Name            Name                Number     Number        Balance" << endl
+		 << "-------  ----            -----           --  ---------  ------------  -------" << endl;
+
+	char balance[CENTS_LENGTH];
+	const OrderIndex& numbers = order(ORDER_NUMBER);
+	for(size_t i = 0; i < numbers.size(); i++) {
+		unsigned int row = numbers.row(i);
+		const AccountDetails& person = people.detail(row);
+		file <<  " " << person.number << "   "
+		     << left << setw(14) << people.lastName(row) << "  "
+			 << setw(14) << people.firstName(row) << "  "
+			 << person.middle << ".  "
+			 << person.social << "  "
+		     << "(" << person.area << ")" << person.phone << "  "
+			 << formatCents(people.balance(row), balance) << endl;
+	}
+	//Total lines up under the balances
+	file << setw(70) << "" << "-------" << endl
+	     << setw(70) << "Total" << formatCents(people.totalBalance(), balance) << endl;
+	return !file.fail();
+}
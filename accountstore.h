@@ -0,0 +1,200 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              accountstore.h
+
+DESCRIPTION:       The accounts, their database file, its journal and the index, behind one interface.
+                   Everything bankacct does to accounts goes through this, menus or not
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __ACCOUNTSTORE_H__
+#define __ACCOUNTSTORE_H__
+
+#include <string>
+#include <cstdio>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "account.h"
+#include "accounttable.h"
+#include "database.h"
+#include "journal.h"
+#include "index.h"
+#include "transaction.h"
+#include "orderindex.h"
+#include "indexfile.h"
+
+//Room for any error load() or openJournal() gives
+#define STORE_ERROR_LENGTH (DB_ERROR_LENGTH > JOURNAL_ERROR_LENGTH ? DB_ERROR_LENGTH : JOURNAL_ERROR_LENGTH)
+
+//A checkpoint writes the database file here, then puts it in place of the real one
+#define STORE_CHECKPOINT_SUFFIX ".checkpoint"
+//How often bankacct checkpoints by default
+#define STORE_CHECKPOINT_SECS 300
+//A binary database is saved by writing just the slots that changed, unless more than one in this many did.
+//Then the whole file is written again, which also gets rid of the free slots
+#define STORE_REWRITE_SHARE 4
+//startLoad() reads this many accounts at a time before letting anything else look at the table
+#define STORE_LOAD_BATCH 65536
+
+using namespace std;
+
+//How far loading a database file has got
+enum LoadState {
+	LOAD_NONE,         //Nothing's been loaded, or stopLoad() stopped it part way through
+	LOAD_RUNNING,      //startLoad()'s thread is still reading it
+	LOAD_DONE,
+	LOAD_BAD_DATABASE, //The database file couldn't be read. loadError() says why
+	LOAD_BAD_JOURNAL   //The journal couldn't be opened. loadError() says why
+};
+
+//What Find matches on, in the order the matches are gone through
+enum FindKind {
+	FIND_NUMBER,
+	FIND_NAME,
+	FIND_FIRST_NAME,
+	FIND_KINDS
+};
+
+//Every account whose number, last name or first name starts with some text.
+//Each kind of match is a range of positions in the OrderIndex for that column
+struct FindMatches {
+	size_t begin[FIND_KINDS];
+	size_t end[FIND_KINDS];
+
+	size_t count() const {
+		size_t total = 0;
+		for(int kind = 0; kind < FIND_KINDS; kind++) total += end[kind] - begin[kind];
+		return total;
+	}
+};
+
+//Accounts are found by row. Rows stay put, except that closing an account moves the last one into
+//its row, and save() sorts them by number again. So a row is only good until the next close() or save().
+//deposit(), withdraw() and transfer() can be called from many threads at once,
+//as long as no two of them are on the same account at the same time and the accounts
+//haven't been sorted by balance with order() (clearOrders() undoes that). Nothing else can,
+//apart from the checkpoint thread startCheckpoints() starts, which looks after itself.
+//While startLoad() is loading in the background, the table can only be looked at with lockTable() held,
+//and nothing can be changed until loadState() is LOAD_DONE
+class AccountStore {
+	private:
+		string fileName;
+		DBFormat format;
+		AccountTable people;
+		AccountIndex index;
+		Journal journal;
+		//Built the first time they're asked for, and kept up to date after that
+		OrderIndex orders[ORDER_COUNT];
+		//How many threads load() was told it could use
+		unsigned int threads;
+
+		//Binary database files only. The slot each row is in, the row in each slot (UINT32_MAX if it's free),
+		//and the free slots, the one to use next last
+		vector<uint32_t> slots;
+		vector<uint32_t> slotRows;
+		vector<uint32_t> freeSlots;
+		uint64_t generation;
+		//One bit for every slot that's changed since the last save. Set by deposit() and friends
+		//on many threads at once, so each word is atomic
+		unique_ptr<atomic<uint64_t>[]> dirty;
+		size_t dirtyWords;
+		//Whether the file has the accounts in the slots above, apart from the dirty ones
+		bool slotsSaved;
+		//Whether the index file has the index and orders as they are now. Then saving only has to restamp it
+		bool indexSaved;
+
+		//The checkpoint thread, and how to tell it to stop
+		thread checkpointer;
+		unsigned int checkpointSecs;
+		mutex checkpointLock;
+		condition_variable checkpointWake;
+		bool stopping;
+		//Held for the whole of a checkpoint, so save() can't happen in the middle of one
+		mutex checkpointing;
+		//Held while accounts are opened or closed, so a checkpoint never copies the table half way through one
+		mutex structure;
+
+		//The database file and its index file while they're being loaded
+		DatabaseReader reader;
+		MappedIndexFile saved;
+		bool haveIndexes;
+		//startLoad()'s thread. It holds tableLock while it reads each batch, and lets go between them
+		//for as long as anything's waiting in lockTable()
+		thread loader;
+		mutex tableLock;
+		atomic<unsigned int> tableWanted;
+		atomic<bool> cancelLoad;
+		atomic<LoadState> state;
+		atomic<unsigned int> loaded;
+		char loadMessage[STORE_ERROR_LENGTH];
+
+		void checkpointLoop();
+		bool beginLoad(const char*, unsigned int, char*);
+		bool readBatch(size_t, char*);
+		void endLoad();
+		bool renumberDuplicates();
+		void loadLoop();
+		void markSlot(uint32_t slot) { dirty[slot / 64].fetch_or(1ull << slot % 64, memory_order_relaxed); }
+		void markRow(unsigned int row) { if(format == DB_BINARY) markSlot(slots[row]); }
+		void clearDirty();
+		void growDirty();
+		void freshSlots();
+		void moveSlots(const vector<uint32_t>&);
+		bool saveSlots();
+		bool saveAll();
+		void saveIndexes();
+	public:
+		AccountStore() : format(DB_TEXT), threads(1), generation(0), dirtyWords(0), slotsSaved(false),
+			indexSaved(false), checkpointSecs(0), stopping(false), haveIndexes(false), tableWanted(0),
+			cancelLoad(false), state(LOAD_NONE), loaded(0) { *loadMessage = '\0'; }
+		~AccountStore() {
+			stopLoad();
+			stopCheckpoints();
+		}
+
+		bool load(const char*, unsigned int, char*);
+		bool startLoad(const char*, unsigned int, char*);
+		void stopLoad();
+		LoadState loadState() const { return state; }
+		//How much of the database file has been read, out of 1000
+		unsigned int loadProgress() const { return loaded; }
+		const char* loadError() const { return loadMessage; }
+		unique_lock<mutex> lockTable();
+		bool openJournal(char*);
+		bool save();
+		bool checkpoint();
+		void startCheckpoints(unsigned int);
+		void stopCheckpoints();
+		void closeJournal() { journal.close(); }
+		void setSync(JournalSync sync, size_t bytes, unsigned int ms) { journal.setPolicy(sync, bytes, ms); }
+
+		const char* name() const { return fileName.c_str(); }
+		DBFormat fileFormat() const { return format; }
+		//Everything about the accounts can be read straight out of the table. Changes go through the store
+		const AccountTable& accounts() const { return people; }
+		size_t size() const { return people.size(); }
+		int find(AccKey key) const { return index.find(key); }
+		int find(const char* number) const { return index.find(number); }
+
+		TxStatus deposit(unsigned int, Cents);
+		TxStatus withdraw(unsigned int, Cents);
+		TxStatus transfer(unsigned int, unsigned int, Cents);
+		TxStatus open(Account*);
+		TxStatus close(unsigned int);
+
+		const OrderIndex& order(OrderColumn);
+		void clearOrders();
+		void findPrefix(const char*, FindMatches*);
+		unsigned int matchRow(const FindMatches&, size_t) const;
+
+		bool report(const char*);
+		void printStats(FILE* file) const { journal.printStats(file); }
+};
+
+#endif
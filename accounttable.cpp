@@ -0,0 +1,283 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              accounttable.cpp
+	DESCRIPTION:       The account table. Keeps the account numbers and balances in arrays of their own
+	                   so that going through all of them doesn't drag every name through the cache
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <algorithm>
+#include "accounttable.h"
+
+using namespace std;
+
+//Copies the parts of an account which aren't in their own columns, putting the names in the arena
+void AccountTable::split(const Account& acc, AccountDetails* details) {
+	NameRef first = names.intern(acc.first);
+	split(acc, first, names.intern(acc.last), details);
+}
+
+void AccountTable::split(const Account& acc, NameRef first, NameRef last, AccountDetails* details) {
+	details->first = first;
+	details->last = last;
+	details->middle = acc.middle;
+	details->social = acc.social;
+	details->area = acc.area;
+	details->phone = acc.phone;
+	memcpy(details->number, acc.number, sizeof(details->number));
+	memcpy(details->password, acc.password, sizeof(details->password));
+	details->nameLength = acc.nameLength;
+}
+
+void AccountTable::reserve(size_t count) {
+	keys.reserve(count);
+	balances.reserve(count);
+	details.reserve(count);
+}
+
+void AccountTable::clear() {
+	keys.clear();
+	balances.clear();
+	details.clear();
+	names.clear();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::get()
+DESCRIPTION:       Puts the account in a row back together
+RETURNS:           The account
+----------------------------------------------------------------------------- */
+Account AccountTable::get(size_t row) const {
+	//Start zeroed so the unused ends of the strings are clean if it gets written to a binary file
+	Account acc = Account();
+	const AccountDetails& d = details[row];
+	strncpy(acc.first, names.get(d.first), FIRST_NAME_LENGTH);
+	strncpy(acc.last, names.get(d.last), LAST_NAME_LENGTH);
+	acc.middle = d.middle;
+	acc.social = d.social;
+	acc.area = d.area;
+	acc.phone = d.phone;
+	acc.balance = balances[row];
+	memcpy(acc.number, d.number, sizeof(acc.number));
+	memcpy(acc.password, d.password, sizeof(acc.password));
+	acc.key = keys[row];
+	acc.nameLength = d.nameLength;
+	return acc;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::append(), insert()
+DESCRIPTION:       Add an account to the end of the table, or in front of row
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountTable::append(const Account& acc) {
+	keys.push_back(acc.key);
+	balances.push_back(acc.balance);
+	details.emplace_back();
+	split(acc, &details.back());
+}
+
+void AccountTable::append(const Account* records, size_t count) {
+	reserve(size() + count);
+	for(size_t i = 0; i < count; i++) append(records[i]);
+}
+
+//For an account whose names are in the arena already, like when the arena's been put back from an index file
+void AccountTable::append(const Account& acc, NameRef first, NameRef last) {
+	keys.push_back(acc.key);
+	balances.push_back(acc.balance);
+	details.emplace_back();
+	split(acc, first, last, &details.back());
+}
+
+void AccountTable::insert(size_t row, const Account& acc) {
+	keys.insert(keys.begin() + row, acc.key);
+	balances.insert(balances.begin() + row, acc.balance);
+	AccountDetails d;
+	split(acc, &d);
+	details.insert(details.begin() + row, d);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::take()
+DESCRIPTION:       Moves every account in other onto the end of this table
+RETURNS:           Void function
+NOTES:             other is left empty, with its memory given back.
+                   other's names are interned again here, so they still only appear once
+----------------------------------------------------------------------------- */
+void AccountTable::take(AccountTable* other) {
+	if(empty()) {
+		keys.swap(other->keys);
+		balances.swap(other->balances);
+		details.swap(other->details);
+		swap(names, other->names);
+		other->clear();
+		return;
+	}
+	keys.insert(keys.end(), other->keys.begin(), other->keys.end());
+	vector<AccKey>().swap(other->keys);
+	balances.insert(balances.end(), other->balances.begin(), other->balances.end());
+	vector<Cents>().swap(other->balances);
+	size_t start = details.size();
+	details.insert(details.end(), other->details.begin(), other->details.end());
+	vector<AccountDetails>().swap(other->details);
+	for(size_t i = start; i < details.size(); i++) {
+		details[i].first = names.intern(other->names.get(details[i].first));
+		details[i].last = names.intern(other->names.get(details[i].last));
+	}
+	other->names.clear();
+}
+
+void AccountTable::erase(size_t row) {
+	keys.erase(keys.begin() + row);
+	balances.erase(balances.begin() + row);
+	details.erase(details.begin() + row);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::eraseUnordered()
+DESCRIPTION:       Erases row by moving the last row into its place
+RETURNS:           Void function
+NOTES:             Constant time, unlike erase(), but the table isn't in number order afterwards
+----------------------------------------------------------------------------- */
+void AccountTable::eraseUnordered(size_t row) {
+	size_t last = size() - 1;
+	if(row != last) {
+		keys[row] = keys[last];
+		balances[row] = balances[last];
+		details[row] = details[last];
+	}
+	keys.pop_back();
+	balances.pop_back();
+	details.pop_back();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::setNumber()
+DESCRIPTION:       Gives the account at row a different number
+RETURNS:           Void function
+NOTES:             The table isn't in number order afterwards
+----------------------------------------------------------------------------- */
+void AccountTable::setNumber(size_t row, AccKey key) {
+	keys[row] = key;
+	unpackAccNum(key, details[row].number);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::lowerBound(), upperBound()
+DESCRIPTION:       Binary search for where key goes. The table must be sorted by number
+RETURNS:           The first row with a key not less than key, or greater than key
+----------------------------------------------------------------------------- */
+size_t AccountTable::lowerBound(AccKey key) const {
+	return lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+size_t AccountTable::upperBound(AccKey key) const {
+	return upper_bound(keys.begin(), keys.end(), key) - keys.begin();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::find()
+DESCRIPTION:       Binary search for an account number. The table must be sorted by number
+RETURNS:           The first row with the number, or -1 if there isn't one
+----------------------------------------------------------------------------- */
+int AccountTable::find(AccKey key) const {
+	size_t row = lowerBound(key);
+	if(row < size() && keys[row] == key) return row;
+	return -1;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::totalBalance()
+DESCRIPTION:       Adds up every balance
+RETURNS:           The total
+----------------------------------------------------------------------------- */
+Cents AccountTable::totalBalance() const {
+	//A straight run over one array of integers, which the compiler can vectorize
+	Cents total = 0;
+	for(Cents balance : balances) total += balance;
+	return total;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTable::sortByNumber()
+DESCRIPTION:       Sorts the table by account number
+RETURNS:           true if any account moved, false if it was already sorted
+NOTES:             Radix sorts (key, row) pairs, then moves every account into place once.
+                   Accounts with the same number stay in the order they were in.
+                   If moved isn't null and anything moved, it's filled with the new row of every old row
+----------------------------------------------------------------------------- */
+bool AccountTable::sortByNumber(vector<uint32_t>* moved) {
+	size_t count = size();
+	//Databases are saved in order, so usually there's nothing to do
+	if(is_sorted(keys.begin(), keys.end())) return false;
+
+	struct SortPair {
+		AccKey key;
+		uint32_t from;
+	};
+	const size_t buckets = 1 << SORT_RADIX_BITS;
+	const AccKey mask = buckets - 1;
+	vector<SortPair> pairs(count), spare(count);
+	bool inRange = true;
+	for(size_t i = 0; i < count; i++) {
+		pairs[i].key = keys[i];
+		pairs[i].from = i;
+		if(pairs[i].key >> SORT_RADIX_BITS * 2) inRange = false;
+	}
+
+	if(inRange) {
+		//Least significant digit first. Each pass is a stable counting sort, so ties keep their order
+		vector<size_t> counts(buckets);
+		for(unsigned int shift = 0; shift < SORT_RADIX_BITS * 2; shift += SORT_RADIX_BITS) {
+			fill(counts.begin(), counts.end(), 0);
+			for(SortPair& pair : pairs) counts[pair.key >> shift & mask]++;
+			size_t total = 0;
+			for(size_t& c : counts) {
+				size_t n = c;
+				c = total;
+				total += n;
+			}
+			for(SortPair& pair : pairs) spare[counts[pair.key >> shift & mask]++] = pair;
+			pairs.swap(spare);
+		}
+	} else {
+		//Something has a key which isn't a real account number. Can't happen with a database
+		//we parsed ourselves, but don't trust that
+		stable_sort(pairs.begin(), pairs.end(), [](const SortPair& a, const SortPair& b) {
+			return a.key < b.key;
+		});
+	}
+	vector<SortPair>().swap(spare);
+	if(moved) {
+		moved->resize(count);
+		for(size_t i = 0; i < count; i++) (*moved)[pairs[i].from] = i;
+	}
+
+	//The hot columns are small, so just gather them into new arrays
+	vector<Cents> sortedBalances(count);
+	for(size_t i = 0; i < count; i++) {
+		keys[i] = pairs[i].key;
+		sortedBalances[i] = balances[pairs[i].from];
+	}
+	balances.swap(sortedBalances);
+
+	//pairs[i].from is the row whose details belong at i. Follow each cycle of that around,
+	//so every row is copied once, plus one spare copy per cycle
+	for(size_t i = 0; i < count; i++) {
+		if(pairs[i].from == i) continue;
+		AccountDetails held = details[i];
+		size_t at = i;
+		while(pairs[at].from != i) {
+			size_t next = pairs[at].from;
+			details[at] = details[next];
+			pairs[at].from = at;
+			at = next;
+		}
+		details[at] = held;
+		pairs[at].from = at;
+	}
+	return true;
+}
@@ -0,0 +1,87 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              accounttable.h
+
+DESCRIPTION:       The accounts in memory, stored a column at a time
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __ACCOUNTTABLE_H__
+#define __ACCOUNTTABLE_H__
+
+#include <vector>
+#include <cstddef>
+#include "account.h"
+#include "namearena.h"
+
+//sortByNumber() sorts keys this many bits at a time. Two passes cover every valid AccKey
+#define SORT_RADIX_BITS 13
+
+using namespace std;
+
+//Everything about an account apart from its balance. Only needed to show an account to someone,
+//or to check their password
+struct AccountDetails {
+	//The names themselves are in the table's NameArena
+	NameRef first;
+	NameRef last;
+	char middle;
+	unsigned int social;
+	unsigned int area;
+	unsigned int phone;
+	char number[ACC_NUM_LENGTH + 1];
+	char password[PASS_LENGTH + 1];
+	//Length of full name (including two spaces and a .)
+	unsigned int nameLength;
+};
+
+//Lookups, sorting and anything which adds up money only touch the keys and balances,
+//so they're kept in their own arrays instead of in between the names.
+//Row i of every column is the same account. Account is still what goes in and out of files.
+//Loading sorts the table by number, but eraseUnordered() and append() leave it out of order until it's sorted again
+class AccountTable {
+	private:
+		vector<AccKey> keys;
+		vector<Cents> balances;
+		vector<AccountDetails> details;
+		NameArena names;
+
+		void split(const Account&, AccountDetails*);
+		void split(const Account&, NameRef, NameRef, AccountDetails*);
+	public:
+		size_t size() const { return keys.size(); }
+		bool empty() const { return keys.empty(); }
+		void reserve(size_t);
+		void clear();
+
+		AccKey key(size_t row) const { return keys[row]; }
+		Cents& balance(size_t row) { return balances[row]; }
+		Cents balance(size_t row) const { return balances[row]; }
+		AccountDetails& detail(size_t row) { return details[row]; }
+		const AccountDetails& detail(size_t row) const { return details[row]; }
+		const char* firstName(size_t row) const { return names.get(details[row].first); }
+		const char* lastName(size_t row) const { return names.get(details[row].last); }
+		const NameArena& nameArena() const { return names; }
+		NameArena& nameArena() { return names; }
+
+		Account get(size_t) const;
+		void append(const Account&);
+		void append(const Account*, size_t);
+		void append(const Account&, NameRef, NameRef);
+		void take(AccountTable*);
+		void insert(size_t, const Account&);
+		void erase(size_t);
+		void eraseUnordered(size_t);
+		void setNumber(size_t, AccKey);
+
+		size_t lowerBound(AccKey) const;
+		size_t upperBound(AccKey) const;
+		int find(AccKey) const;
+
+		Cents totalBalance() const;
+		bool sortByNumber(vector<uint32_t>*);
+};
+
+#endif
@@ -2,7 +2,7 @@
 
 FILE:              bankacct.h
 
-DESCRIPTION:       Header file for my project. Contains constants, structures, and classes needed for main program
+DESCRIPTION:       Header file for my project. Contains constants, structures, and classes needed for main program and the menus
 
 COMPILER:          g++ with c++ 11
 
@@ -20,10 +20,11 @@ Alexander Novotny         2016-10-13         1.0.0
 //Semvers
 #define VERSION "0.0.1" 
 
-#define FIRST_NAME_LENGTH 50
-#define LAST_NAME_LENGTH 50
-#define ACC_NUM_LENGTH 5
-#define PASS_LENGTH 6
+#include <string>
+#include <vector>
+#include "account.h"
+#include "accountstore.h"
+#include "batch.h"
 
 //This stuff defines how the menus looks (in case I want to change it later)
 //I'm also doing this for purposes of literacy
@@ -55,52 +56,57 @@ Alexander Novotny         2016-10-13         1.0.0
 #define TRANS_MIN_HEIGHT 10
 #define TRANS_MID_COL 10
 
+//Find in the main menu. Longest thing that can be typed in
+#define FIND_LENGTH 50
+//How often the main menu is drawn again while the database is loading
+#define LOAD_REFRESH_MS 100
+
 //New Account Menu
 #define NEWACC_LEFTSHIFT 20
 
 using namespace std;
 
-struct Account {
-	char first[FIRST_NAME_LENGTH + 1];
-	char last[LAST_NAME_LENGTH + 1];
-	char middle;
-	unsigned int social;
-	unsigned int area;
-	unsigned int phone;
-	double balance;
-	char number[ACC_NUM_LENGTH + 1];
-	char password[PASS_LENGTH + 1];
-	//Length of full name (including two spaces and a .)
-	unsigned int nameLength;
+//What the main menu drew last time, so next time only what's changed has to be drawn again
+struct MainMenuFrame {
+	bool valid; //When this is false everything gets drawn, like after another menu's been on the screen
+	unsigned int height, width;
+	OrderColumn column;
+	vector<string> lines; //Each line of the list as it's on the screen, brackets and all
+	string keys; //The bottom line, which is the find prompt while finding
+	MainMenuFrame() : valid(false), height(0), width(0), column(ORDER_NUMBER) {}
 };
 
+//The accounts the menus show. Defined in menus.cpp, along with the menus themselves
+extern AccountStore store;
+
+void setupScreen();
+void mainMenu(const AccountTable*);
+void displayAccount(const AccountTable*, unsigned int);
+void deposit(const AccountTable*, unsigned int);
+void withdraw(const AccountTable*, unsigned int);
+void transfer(const AccountTable*, unsigned int);
+int transferAccount(const AccountTable*, unsigned int);
+void transferAmmount(const AccountTable*, unsigned int, unsigned int);
+bool close(const AccountTable*, unsigned int);
+void openAccount(const AccountTable*);
+void createReport(const AccountTable*);
+void showError(char const*, char const*);
+void txError(TxStatus);
 
 class WriteOnShutdown {
 	private:
-		const char* filename;
-		vector<Account>* database;
+		AccountStore* store;
 	public:
-		WriteOnShutdown(char* a, vector<Account>* b) : filename(a), database(b) {}
+		WriteOnShutdown(AccountStore* a) : store(a) {}
 		
 		/* -----------------------------------------------------------------------------
 		FUNCTION:          ~WriteOnShutdown()
 		DESCRIPTION:       Destructor for WriteOnShutdown. When WriteOnShutdown gets deleted, 
-                                   it writes the database to the specified output file
+                                   it saves the store's database file in the same format it was loaded from
 		RETURNS:           Void function
 		----------------------------------------------------------------------------- */
 		~WriteOnShutdown() {
-			ofstream out(filename);
-			for(Account& acc : *database) {
-				out << acc.first << endl
-				    << acc.last << endl
-					<< acc.middle << endl
-					<< acc.social << endl
-					<< acc.area << endl
-					<< acc.phone << endl
-					<< acc.balance << endl
-					<< acc.number << endl
-					<< acc.password << endl << endl;
-			}
+			store->save();
 			getch();
 		}
 };
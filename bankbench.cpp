@@ -0,0 +1,227 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              bankbench.cpp
+	DESCRIPTION:       Benchmarks everything bankacct does with a database on made up databases of different sizes:
+	                   loading, sorting, looking accounts up by number, writing a report, applying a batch
+	                   of transactions, checkpointing and saving, how fast saving writes, and saving a binary
+	                   database after one transfer, which only writes the slots that changed, and getting a binary
+                   database ready to find accounts in, with and without its index file
+	USAGE:             bankbench [-d directory] [count ...]
+	                   For each count, makes a text database with that many accounts and a transactions file
+	                   with as many transactions in directory (/tmp by default), times each step, and prints
+	                   one line of JSON. The files are removed afterwards. Without any counts, it does 10000 and 1000000
+	COMPILER:          Built on g++ with c++11
+	Exit Codes:
+		- 0: All good
+		- 1: Bad arguments
+		- 2: Something that was being timed failed
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "accountstore.h"
+#include "batch.h"
+#include "generate.h"
+
+//The commit the benchmark was built from, so results can be told apart. The Makefile fills it in
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+//How many lookups are timed, whatever the size of the database
+#define BENCH_LOOKUPS 1000000
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          millisSince()
+DESCRIPTION:       Works out how long it's been since start
+RETURNS:           Milliseconds
+----------------------------------------------------------------------------- */
+double millisSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          fail()
+DESCRIPTION:       Tells the user what went wrong
+RETURNS:           The exit code for it
+----------------------------------------------------------------------------- */
+int fail(const char* program, const char* what, const char* why) {
+	fprintf(stderr, "%s: %s: %s\n", program, what, why);
+	return 2;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          bench()
+DESCRIPTION:       Runs every benchmark on count accounts, with its files in directory, and prints the results
+RETURNS:           See Exit Codes
+----------------------------------------------------------------------------- */
+int bench(const char* program, const string& directory, size_t count, unsigned int threads) {
+	string base = directory + "/bankbench-" + to_string(count);
+	string dbName = base + ".db", txName = base + ".tx", resultsName = base + ".results", reportName = base + ".rpt";
+	string binaryName = base + ".bin";
+	char error[STORE_ERROR_LENGTH > BATCH_ERROR_LENGTH ? STORE_ERROR_LENGTH : BATCH_ERROR_LENGTH];
+
+	//Making the files isn't timed
+	{
+		AccountTable people;
+		generateAccounts(&people, count, GENERATE_SEED);
+		if(!writeTextDatabase(dbName.c_str(), &people)) return fail(program, dbName.c_str(), "could not be written");
+		if(!generateTransactions(txName.c_str(), &people, count, GENERATE_SEED + 1)) {
+			return fail(program, txName.c_str(), "could not be written");
+		}
+	}
+
+	//The steps loading goes through, one at a time
+	double loadMs, sortMs, indexMs, lookupNs;
+	{
+		AccountTable people;
+		DBFormat format;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!readDatabase(dbName.c_str(), &people, &format, error, threads)) return fail(program, dbName.c_str(), error);
+		loadMs = millisSince(start);
+
+		start = chrono::steady_clock::now();
+		people.sortByNumber(nullptr);
+		sortMs = millisSince(start);
+
+		AccountIndex index;
+		start = chrono::steady_clock::now();
+		index.build(&people);
+		indexMs = millisSince(start);
+
+		//Numbers typed in as text, like the menus and batch mode get them
+		vector<array<char, ACC_NUM_LENGTH + 1>> numbers(BENCH_LOOKUPS);
+		Random random(GENERATE_SEED + 2);
+		for(auto& number : numbers) unpackAccNum(people.key(random.below(people.size())), number.data());
+		start = chrono::steady_clock::now();
+		size_t found = 0;
+		for(auto& number : numbers) found += index.find(number.data()) >= 0;
+		lookupNs = millisSince(start) * 1000000 / BENCH_LOOKUPS;
+		if(found != BENCH_LOOKUPS) return fail(program, "lookups", "an account that exists wasn't found");
+	}
+
+	//Everything else goes through the store, the same way bankacct does it
+	double openMs, reportMs, batchMs, checkpointMs, saveMs, saveMBs;
+	BatchCounts counts;
+	{
+		AccountStore store;
+		store.setSync(JOURNAL_SYNC_ASYNC, JOURNAL_GROUP_BYTES, JOURNAL_ASYNC_MS);
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!store.load(dbName.c_str(), threads, error) || !store.openJournal(error)) {
+			return fail(program, dbName.c_str(), error);
+		}
+		openMs = millisSince(start);
+
+		start = chrono::steady_clock::now();
+		if(!store.report(reportName.c_str())) return fail(program, reportName.c_str(), "could not be written");
+		reportMs = millisSince(start);
+
+		start = chrono::steady_clock::now();
+		if(!runBatch(txName.c_str(), resultsName.c_str(), &store, threads, &counts, error)) {
+			return fail(program, txName.c_str(), error);
+		}
+		batchMs = millisSince(start);
+
+		//The whole of a checkpoint, though only the fork holds anything else up
+		start = chrono::steady_clock::now();
+		if(!store.checkpoint()) return fail(program, dbName.c_str(), "could not be checkpointed");
+		checkpointMs = millisSince(start);
+
+		start = chrono::steady_clock::now();
+		if(!store.save()) return fail(program, dbName.c_str(), "could not be saved");
+		saveMs = millisSince(start);
+		//Megabytes of database written a second, syncing included
+		struct stat info;
+		if(stat(dbName.c_str(), &info)) return fail(program, dbName.c_str(), "went missing after saving");
+		saveMBs = info.st_size / 1e6 / (saveMs / 1000);
+		if(!writeBinaryDatabase(binaryName.c_str(), &store.accounts())) {
+			return fail(program, binaryName.c_str(), "could not be written");
+		}
+		store.closeJournal();
+	}
+
+	//What saving costs when hardly anything has changed
+	double slotSaveMs;
+	{
+		AccountStore store;
+		if(!store.load(binaryName.c_str(), threads, error) || !store.openJournal(error)) {
+			return fail(program, binaryName.c_str(), error);
+		}
+		//From the first account with anything in it, so one slot really does change
+		unsigned int from = 0;
+		while(from < store.size() && store.accounts().balance(from) <= 0) from++;
+		if(from == store.size() || store.transfer(from, store.size() - 1, 1) != TX_OK) {
+			return fail(program, binaryName.c_str(), "the transfer to save could not be made");
+		}
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!store.save()) return fail(program, binaryName.c_str(), "could not be saved");
+		slotSaveMs = millisSince(start);
+		store.closeJournal();
+	}
+
+	//Getting a binary database ready to find accounts in, without and then with the index file saving leaves
+	double binaryOpenMs = 0, indexedOpenMs = 0;
+	for(int indexed = 0; indexed < 2; indexed++) {
+		if(!indexed) unlink((binaryName + INDEX_FILE_SUFFIX).c_str());
+		AccountStore store;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!store.load(binaryName.c_str(), threads, error) || !store.openJournal(error)) {
+			return fail(program, binaryName.c_str(), error);
+		}
+		for(OrderColumn column : {ORDER_NAME, ORDER_FIRST_NAME, ORDER_SOCIAL}) store.order(column);
+		(indexed ? indexedOpenMs : binaryOpenMs) = millisSince(start);
+		if(!store.save()) return fail(program, binaryName.c_str(), "could not be saved");
+		store.closeJournal();
+	}
+
+	printf("{\"commit\":\"%s\",\"records\":%zu,\"threads\":%u,\"load_ms\":%.1f,\"sort_ms\":%.1f,\"index_ms\":%.1f,"
+		"\"lookup_ns\":%.1f,\"store_open_ms\":%.1f,\"report_ms\":%.1f,\"batch_transactions\":%llu,"
+		"\"batch_applied\":%llu,\"batch_ms\":%.1f,\"checkpoint_ms\":%.1f,\"save_ms\":%.1f,\"save_mb_s\":%.1f,"
+		"\"slot_save_ms\":%.1f,\"binary_open_ms\":%.1f,\"indexed_open_ms\":%.1f}\n",
+		BENCH_COMMIT, count, threads, loadMs, sortMs, indexMs, lookupNs, openMs, reportMs,
+		(unsigned long long) counts.transactions, (unsigned long long) counts.applied, batchMs, checkpointMs, saveMs, saveMBs,
+		slotSaveMs, binaryOpenMs, indexedOpenMs);
+	fflush(stdout);
+
+	for(const string& name : {dbName, dbName + JOURNAL_SUFFIX, dbName + INDEX_FILE_SUFFIX, binaryName,
+		binaryName + JOURNAL_SUFFIX, binaryName + INDEX_FILE_SUFFIX, txName, resultsName, reportName}) unlink(name.c_str());
+	return 0;
+}
+
+int main(int argc, char** argv) {
+	string directory = "/tmp";
+	vector<size_t> counts;
+	for(int i = 1; i < argc; i++) {
+		if(!strcmp(argv[i], "-d") && i + 1 < argc) {
+			directory = argv[++i];
+			continue;
+		}
+		char* end;
+		unsigned long long count = strtoull(argv[i], &end, 10);
+		if(*end || !count || count > UINT32_MAX) {
+			fprintf(stderr, "Usage: %s [-d directory] [count ...]\n", argv[0]);
+			return 1;
+		}
+		counts.push_back(count);
+	}
+	if(counts.empty()) counts = {10000, 1000000};
+
+	unsigned int threads = thread::hardware_concurrency();
+	if(!threads) threads = 1;
+	for(size_t count : counts) {
+		int status = bench(argv[0], directory, count, threads);
+		if(status) return status;
+	}
+	return 0;
+}
@@ -0,0 +1,382 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              batch.cpp
+	DESCRIPTION:       Batch mode. Reads a file of transactions, one per line, applies each of them
+	                   with the same checks the menus use, and writes how each one went to a results file
+	COMPILER:          Built on g++ with c++11
+
+	A transactions file looks like this. Words are separated by spaces or tabs,
+	and blank lines and lines starting with # are skipped:
+		deposit NUMBER AMOUNT
+		withdraw NUMBER AMOUNT
+		transfer FROM TO AMOUNT
+		open FIRST LAST MIDDLE SOCIAL AREA PHONE BALANCE NUMBER PASSWORD
+		close NUMBER
+	The results file gets one line per transaction: the line number it was on, then either
+	"ok" and the new balances (if any), or the name of the TxStatus it was rejected with
+
+	Deposits, withdrawals and transfers are applied on several threads at once. Each account still sees
+	its transactions in the order they're in the file (see AccountTurns), so the balances and results
+	are exactly what applying them one at a time would give. Opening and closing accounts moves rows
+	around, so those are done on their own, once everything before them is finished
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include "batch.h"
+
+using namespace std;
+
+//The results file is written in big pieces, since there's a line for every transaction
+#define BATCH_OUTPUT_BUFFER (1 << 20)
+
+//The kinds of transactions which can go in a window
+enum BatchOp {
+	//Already rejected when it was read. Its status says why
+	BATCH_NONE,
+	BATCH_DEPOSIT,
+	BATCH_WITHDRAW,
+	BATCH_TRANSFER
+};
+
+//A deposit, withdrawal or transfer waiting in a window
+struct BatchTx {
+	unsigned long line;
+	BatchOp op;
+	TxStatus status;
+	//A deposit or withdrawal has the same row in both
+	uint32_t row, to;
+	//Turns at row and to. See AccountTurns
+	uint32_t rowTicket, toTicket;
+	Cents amount;
+	//The balances once it's applied
+	Cents rowBalance, toBalance;
+};
+
+void AccountTurns::resize(size_t accounts) {
+	if(accounts <= count) return;
+	turns.reset(new atomic<uint32_t>[accounts]);
+	for(size_t i = 0; i < accounts; i++) turns[i].store(0, memory_order_relaxed);
+	count = accounts;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTurns::wait()
+DESCRIPTION:       Waits until it's ticket's turn at the account in row
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountTurns::wait(uint32_t row, uint32_t ticket) {
+	//Nearly always it's our turn already, or it soon will be
+	for(int spins = 0; spins < 64; spins++) {
+		if(turns[row].load(memory_order_acquire) == ticket) return;
+		this_thread::yield();
+	}
+	Stripe& stripe = stripes[row % BATCH_STRIPES];
+	unique_lock<mutex> guard(stripe.lock);
+	stripe.waiting++;
+	stripe.changed.wait(guard, [&]() { return turns[row].load(memory_order_acquire) == ticket; });
+	stripe.waiting--;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountTurns::done()
+DESCRIPTION:       Passes the account in row on to the next transaction that uses it
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountTurns::done(uint32_t row) {
+	turns[row].fetch_add(1);
+	//Anyone who goes to sleep counts themselves before checking their turn, so they can't be missed here
+	Stripe& stripe = stripes[row % BATCH_STRIPES];
+	if(stripe.waiting.load()) {
+		lock_guard<mutex> guard(stripe.lock);
+		stripe.changed.notify_all();
+	}
+}
+
+//Splits a line into '\0' terminated words
+//Returns how many there were, or -1 if there were too many or one was too long
+static int splitWords(const char* line, const char* end, char words[BATCH_MAX_WORDS][BATCH_WORD_LENGTH]) {
+	int count = 0;
+	while(true) {
+		while(line < end && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+		if(line >= end) return count;
+		if(count == BATCH_MAX_WORDS) return -1;
+		const char* start = line;
+		while(line < end && *line != ' ' && *line != '\t' && *line != '\r') line++;
+		if(line - start >= BATCH_WORD_LENGTH) return -1;
+		memcpy(words[count], start, line - start);
+		words[count][line - start] = '\0';
+		count++;
+	}
+}
+
+//Finds the row of an account number, or -1 if there's no such account
+static int findAccount(const AccountStore* store, const char* number) {
+	if(strlen(number) != ACC_NUM_LENGTH) return -1;
+	AccKey key = packAccNum(number);
+	if(key == ACC_KEY_INVALID) return -1;
+	return store->find(key);
+}
+
+//Reads a deposit, withdrawal or transfer amount
+static bool readAmount(const char* word, Cents* amount) {
+	return parseAmount(word, word + strlen(word), amount);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readTx()
+DESCRIPTION:       Reads a deposit, withdrawal or transfer from words into tx
+RETURNS:           Void function
+NOTES:             If it can't be applied, tx's op is BATCH_NONE and its status says why
+----------------------------------------------------------------------------- */
+static void readTx(char words[BATCH_MAX_WORDS][BATCH_WORD_LENGTH], int count, const AccountStore* store, BatchTx* tx) {
+	const char* op = words[0];
+	int row, to = -1;
+	tx->op = BATCH_NONE;
+	if(count != (op[0] == 't' ? 4 : 3)) {
+		tx->status = TX_MALFORMED;
+		return;
+	}
+	if((row = findAccount(store, words[1])) < 0 || (count == 4 && (to = findAccount(store, words[2])) < 0)) {
+		tx->status = TX_NO_ACCOUNT;
+		return;
+	}
+	if(!readAmount(words[count - 1], &tx->amount)) {
+		tx->status = TX_BAD_AMOUNT;
+		return;
+	}
+	tx->op = op[0] == 'd' ? BATCH_DEPOSIT : op[0] == 'w' ? BATCH_WITHDRAW : BATCH_TRANSFER;
+	//Until it's actually applied
+	tx->status = TX_SKIPPED;
+	tx->row = row;
+	tx->to = to < 0 ? row : to;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyTx()
+DESCRIPTION:       Waits for tx's turn at its accounts, applies it, and passes them on
+RETURNS:           Void function
+NOTES:             Once failed is set, nothing else is applied, but the turns are still passed on
+                   so that no one is left waiting
+----------------------------------------------------------------------------- */
+static void applyTx(BatchTx* tx, AccountStore* store, AccountTurns* turns, atomic<bool>* failed) {
+	if(tx->op == BATCH_NONE) return;
+	bool two = tx->to != tx->row;
+	//Always the lower row first, like taking locks in a fixed order. Every turn we could be waiting on
+	//belongs to a transaction earlier in the file, so nothing can end up waiting in a circle
+	if(two && tx->to < tx->row) {
+		turns->wait(tx->to, tx->toTicket);
+		turns->wait(tx->row, tx->rowTicket);
+	} else {
+		turns->wait(tx->row, tx->rowTicket);
+		if(two) turns->wait(tx->to, tx->toTicket);
+	}
+
+	if(!failed->load(memory_order_relaxed)) {
+		switch(tx->op) {
+			case BATCH_DEPOSIT:
+				tx->status = store->deposit(tx->row, tx->amount);
+				break;
+			case BATCH_WITHDRAW:
+				tx->status = store->withdraw(tx->row, tx->amount);
+				break;
+			default:
+				tx->status = store->transfer(tx->row, tx->to, tx->amount);
+				break;
+		}
+		if(tx->status == TX_JOURNAL) failed->store(true);
+		tx->rowBalance = store->accounts().balance(tx->row);
+		tx->toBalance = store->accounts().balance(tx->to);
+	}
+
+	turns->done(tx->row);
+	if(two) turns->done(tx->to);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyWindow()
+DESCRIPTION:       Applies every transaction in window, using up to threads threads
+RETURNS:           false if one couldn't be logged to the journal, true otherwise
+NOTES:             uses has a count for each account, which has to start and is left at 0
+----------------------------------------------------------------------------- */
+static bool applyWindow(vector<BatchTx>* window, AccountStore* store, unsigned int threads,
+	vector<uint32_t>* uses, AccountTurns* turns) {
+	//Hand out tickets in file order
+	uses->resize(store->size());
+	turns->resize(store->size());
+	for(BatchTx& tx : *window) {
+		if(tx.op == BATCH_NONE) continue;
+		tx.rowTicket = (*uses)[tx.row]++;
+		if(tx.to != tx.row) tx.toTicket = (*uses)[tx.to]++;
+	}
+
+	//Chunks are taken in order, and a chunk that's been taken is always finished, so every turn
+	//anyone waits on belongs to someone who will get to it
+	atomic<size_t> next(0);
+	atomic<bool> failed(false);
+	auto work = [&]() {
+		while(!failed.load(memory_order_relaxed)) {
+			size_t start = next.fetch_add(BATCH_CHUNK);
+			if(start >= window->size()) break;
+			size_t stop = min(start + BATCH_CHUNK, window->size());
+			for(size_t i = start; i < stop; i++) applyTx(&(*window)[i], store, turns, &failed);
+		}
+	};
+	size_t chunks = (window->size() + BATCH_CHUNK - 1) / BATCH_CHUNK;
+	vector<thread> workers;
+	for(unsigned int i = 1; i < threads && i < chunks; i++) workers.emplace_back(work);
+	work();
+	for(thread& worker : workers) worker.join();
+
+	for(BatchTx& tx : *window) {
+		if(tx.op == BATCH_NONE) continue;
+		(*uses)[tx.row] = (*uses)[tx.to] = 0;
+		turns->reset(tx.row);
+		turns->reset(tx.to);
+	}
+	return !failed;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          writeWindow()
+DESCRIPTION:       Writes how every transaction in window went to results, and adds them to counts
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+static void writeWindow(const vector<BatchTx>& window, FILE* results, BatchCounts* counts) {
+	char balance[CENTS_LENGTH];
+	for(const BatchTx& tx : window) {
+		counts->transactions++;
+		fprintf(results, "%lu", tx.line);
+		if(tx.status != TX_OK) {
+			fprintf(results, " %s\n", txStatusName(tx.status));
+			counts->rejected++;
+			continue;
+		}
+		counts->applied++;
+		fprintf(results, " ok %s", formatCents(tx.rowBalance, balance));
+		if(tx.op == BATCH_TRANSFER) fprintf(results, " %s", formatCents(tx.toBalance, balance));
+		fputc('\n', results);
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyAccountLine()
+DESCRIPTION:       Opens or closes the account in words
+RETURNS:           How it went
+----------------------------------------------------------------------------- */
+static TxStatus applyAccountLine(char words[BATCH_MAX_WORDS][BATCH_WORD_LENGTH], int count, AccountStore* store) {
+	if(!strcmp(words[0], "open")) {
+		if(count != 1 + FIELD_COUNT) return TX_MALFORMED;
+		//Zeroed so that it goes into the journal without any junk in it
+		Account acc = Account();
+		for(int field = 0; field < FIELD_COUNT; field++) {
+			if(!setAccountField(&acc, field, words[1 + field])) return TX_BAD_FIELD;
+		}
+		return store->open(&acc);
+	}
+	if(count != 2) return TX_MALFORMED;
+	int row = findAccount(store, words[1]);
+	if(row < 0) return TX_NO_ACCOUNT;
+	//The file is trusted, so there's no password to check
+	return store->close(row);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          runBatch()
+DESCRIPTION:       Applies every transaction in the file transactionsName to store,
+                   and writes a line for each of them to the file resultsName
+RETURNS:           true if the whole file was gone through, false otherwise
+NOTES:             Rejected transactions don't stop the batch. Not being able to log one to the journal does,
+                   since the ones after it might depend on it. error is filled in when false is returned,
+                   and counts is kept up to date either way.
+                   Deposits, withdrawals and transfers are applied on up to threads threads
+----------------------------------------------------------------------------- */
+bool runBatch(const char* transactionsName, const char* resultsName, AccountStore* store, unsigned int threads,
+	BatchCounts* counts, char* error) {
+	*counts = BatchCounts();
+	//Keeping a balance order up to date isn't safe from many threads at once, and nothing here needs one
+	store->clearOrders();
+
+	MappedFile transactions;
+	if(!transactions.open(transactionsName)) {
+		snprintf(error, BATCH_ERROR_LENGTH, "Could not read \"%s\"", transactionsName);
+		return false;
+	}
+	FILE* results = fopen(resultsName, "w");
+	if(!results) {
+		snprintf(error, BATCH_ERROR_LENGTH, "Could not create \"%s\"", resultsName);
+		return false;
+	}
+	setvbuf(results, nullptr, _IOFBF, BATCH_OUTPUT_BUFFER);
+
+	vector<BatchTx> window;
+	window.reserve(BATCH_WINDOW);
+	vector<uint32_t> uses;
+	AccountTurns turns;
+	bool journalFailed = false;
+	//Applies whatever has built up in the window
+	auto flush = [&]() {
+		if(window.empty()) return;
+		if(!applyWindow(&window, store, threads, &uses, &turns)) journalFailed = true;
+		writeWindow(window, results, counts);
+		window.clear();
+	};
+
+	char words[BATCH_MAX_WORDS][BATCH_WORD_LENGTH];
+	const char* pos = transactions.data();
+	const char* end = pos + transactions.size();
+	for(unsigned long lineNum = 1; pos < end && !journalFailed; lineNum++) {
+		const char* line = pos;
+		const char* newline = (const char*) memchr(pos, '\n', end - pos);
+		const char* lineEnd = newline ? newline : end;
+		pos = newline ? newline + 1 : end;
+
+		while(line < lineEnd && (*line == ' ' || *line == '\t' || *line == '\r')) line++;
+		if(line == lineEnd || *line == '#') continue;
+		int count = splitWords(line, lineEnd, words);
+
+		if(count > 0 && (!strcmp(words[0], "open") || !strcmp(words[0], "close"))) {
+			//Rows move, so everything before it has to be done first
+			flush();
+			if(journalFailed) break;
+			TxStatus status = applyAccountLine(words, count, store);
+			counts->transactions++;
+			if(status == TX_OK) {
+				fprintf(results, "%lu ok\n", lineNum);
+				counts->applied++;
+			} else {
+				fprintf(results, "%lu %s\n", lineNum, txStatusName(status));
+				counts->rejected++;
+			}
+			if(status == TX_JOURNAL) journalFailed = true;
+			continue;
+		}
+
+		window.emplace_back();
+		BatchTx& tx = window.back();
+		tx.line = lineNum;
+		if(count > 0 && (!strcmp(words[0], "deposit") || !strcmp(words[0], "withdraw") || !strcmp(words[0], "transfer"))) {
+			readTx(words, count, store, &tx);
+		} else {
+			tx.op = BATCH_NONE;
+			tx.status = TX_MALFORMED;
+		}
+		if(window.size() == BATCH_WINDOW) flush();
+	}
+	flush();
+
+	bool written = !ferror(results);
+	if(fclose(results)) written = false;
+	if(journalFailed) {
+		snprintf(error, BATCH_ERROR_LENGTH, "Could not log a transaction to the journal. The rest were skipped");
+		return false;
+	}
+	if(!written) {
+		snprintf(error, BATCH_ERROR_LENGTH, "Could not write \"%s\"", resultsName);
+		return false;
+	}
+	return true;
+}
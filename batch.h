@@ -0,0 +1,73 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              batch.h
+
+DESCRIPTION:       Batch mode. Applies a file of transactions to the accounts without any menus
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __BATCH_H__
+#define __BATCH_H__
+
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "accountstore.h"
+
+#define BATCH_ERROR_LENGTH 100
+//The most words on one line of a transactions file. open has the most
+#define BATCH_MAX_WORDS 10
+//Longer words than this can't be valid, whatever they are
+#define BATCH_WORD_LENGTH 64
+//Deposits, withdrawals and transfers are gathered into windows of up to this many, which are applied in parallel
+#define BATCH_WINDOW (1 << 18)
+//Each thread takes this many transactions from the window at a time
+#define BATCH_CHUNK 64
+//Threads waiting for an account to be free wait on one of this many locks, picked by the account's row
+#define BATCH_STRIPES 64
+
+using namespace std;
+
+struct BatchCounts {
+	uint64_t transactions;
+	uint64_t applied;
+	uint64_t rejected;
+};
+
+//Makes transactions take turns at each account, in the order they're in the file, so that running them
+//on many threads comes out the same as running them one after another.
+//A transaction's ticket for an account is how many transactions before it in the window use that account,
+//and it can't touch the account until that many have finished with it.
+//Whoever has an account's turn is the only one using it, so the accounts themselves don't need locking
+class AccountTurns {
+	private:
+		//Only for sleeping until a turn comes up. Cache line sized, so threads on different stripes
+		//don't slow each other down
+		struct alignas(64) Stripe {
+			mutex lock;
+			condition_variable changed;
+			atomic<unsigned int> waiting;
+		};
+		//How many transactions have finished with each account
+		unique_ptr<atomic<uint32_t>[]> turns;
+		size_t count;
+		Stripe stripes[BATCH_STRIPES];
+	public:
+		AccountTurns() : count(0) {
+			for(Stripe& stripe : stripes) stripe.waiting = 0;
+		}
+
+		void resize(size_t);
+		//Only while no one is waiting
+		void reset(uint32_t row) { turns[row].store(0, memory_order_relaxed); }
+		void wait(uint32_t, uint32_t);
+		void done(uint32_t);
+};
+
+bool runBatch(const char*, const char*, AccountStore*, unsigned int, BatchCounts*, char*);
+
+#endif
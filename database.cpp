@@ -0,0 +1,841 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              database.cpp
+	DESCRIPTION:       Reading and writing of database files
+	                   Text databases are nine lines per account with a blank line between accounts
+	                   Binary databases are a DBHeader followed by fixed-size Account records, one per slot,
+	                   which can be written over in place
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "database.h"
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedFile::open()
+DESCRIPTION:       Maps a whole file into memory, read only
+RETURNS:           true if the file was mapped, false otherwise
+NOTES:             An empty file is mapped successfully with a null data()
+----------------------------------------------------------------------------- */
+bool MappedFile::open(const char* fileName) {
+	close();
+
+	int fd = ::open(fileName, O_RDONLY);
+	if(fd < 0) return false;
+	struct stat info;
+	if(fstat(fd, &info)) {
+		::close(fd);
+		return false;
+	}
+	if(!info.st_size) {
+		::close(fd);
+		return true;
+	}
+
+	map = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	//The mapping stays valid after the file is closed
+	::close(fd);
+	if(map == MAP_FAILED) {
+		map = nullptr;
+		return false;
+	}
+	length = info.st_size;
+	//We're going to read the whole thing front to back, so let the kernel read ahead
+	madvise(map, length, MADV_SEQUENTIAL);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedFile::close()
+DESCRIPTION:       Unmaps the file, if there is one
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void MappedFile::close() {
+	if(map) munmap(map, length);
+	map = nullptr;
+	length = 0;
+}
+
+//Writes all of data to fd, however many goes that takes
+static bool writeAll(int fd, const char* data, size_t length) {
+	while(length) {
+		ssize_t written = ::write(fd, data, length);
+		if(written < 0) {
+			if(errno == EINTR) continue;
+			return false;
+		}
+		data += written;
+		length -= written;
+	}
+	return true;
+}
+
+//Writes all of data to fd at offset, however many goes that takes
+static bool pwriteAll(int fd, const char* data, size_t length, off_t offset) {
+	while(length) {
+		ssize_t written = pwrite(fd, data, length, offset);
+		if(written < 0) {
+			if(errno == EINTR) continue;
+			return false;
+		}
+		data += written;
+		length -= written;
+		offset += written;
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          FileWriter::open()
+DESCRIPTION:       Starts writing a new version of the file fileName
+RETURNS:           true if the temporary file was made, false otherwise
+NOTES:             The new file gets the same permissions as the one it's replacing
+----------------------------------------------------------------------------- */
+bool FileWriter::open(const char* name) {
+	abandon();
+	fileName = name;
+	tempName = fileName + DB_TEMP_SUFFIX;
+	struct stat info;
+	bool replacing = !stat(name, &info);
+	fd = ::open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if(fd < 0) return false;
+	if(replacing) fchmod(fd, info.st_mode & 07777);
+	buffer.resize(DB_WRITE_BUFFER);
+	used = 0;
+	failed = false;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          FileWriter::writeOut()
+DESCRIPTION:       Writes out what's in the buffer to make room for length more bytes of data,
+                   or writes data straight out too if it wouldn't fit anyway
+RETURNS:           Void function
+NOTES:             Errors are remembered, and commit() fails because of them
+----------------------------------------------------------------------------- */
+void FileWriter::writeOut(const char* data, size_t length) {
+	if(fd < 0 || failed) return;
+	if(!writeAll(fd, buffer.data(), used)) failed = true;
+	used = 0;
+	if(length >= buffer.size()) {
+		if(!writeAll(fd, data, length)) failed = true;
+	} else {
+		memcpy(buffer.data(), data, length);
+		used = length;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          FileWriter::commit()
+DESCRIPTION:       Finishes writing the file, syncs it to disk and puts it in place of the old one
+RETURNS:           true if the new file is in place, false if the old one is still there
+----------------------------------------------------------------------------- */
+bool FileWriter::commit() {
+	if(fd < 0) return false;
+	writeOut(nullptr, 0);
+	if(failed || fsync(fd)) {
+		abandon();
+		return false;
+	}
+	int closed = ::close(fd);
+	fd = -1;
+	vector<char>().swap(buffer);
+	if(closed || rename(tempName.c_str(), fileName.c_str())) {
+		unlink(tempName.c_str());
+		return false;
+	}
+	//The rename is only on disk once the directory it's in is, so sync that too
+	size_t slash = fileName.rfind('/');
+	string directory = slash == string::npos ? "." : slash ? fileName.substr(0, slash) : "/";
+	int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if(dir >= 0) {
+		fsync(dir);
+		::close(dir);
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          FileWriter::abandon()
+DESCRIPTION:       Stops writing and removes the temporary file, leaving the old file as it was
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void FileWriter::abandon() {
+	if(fd >= 0) {
+		::close(fd);
+		unlink(tempName.c_str());
+		fd = -1;
+	}
+	vector<char>().swap(buffer);
+	used = 0;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          SlotWriter::open()
+DESCRIPTION:       Starts writing slots of the binary database file fileName in place
+RETURNS:           true if the file was opened, false otherwise
+----------------------------------------------------------------------------- */
+bool SlotWriter::open(const char* fileName) {
+	close();
+	fd = ::open(fileName, O_WRONLY);
+	if(fd < 0) return false;
+	buffer.resize(DB_WRITE_BUFFER / sizeof(Account) * sizeof(Account));
+	held = 0;
+	failed = false;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          SlotWriter::write()
+DESCRIPTION:       Writes acc into slot
+RETURNS:           Void function
+NOTES:             Only goes into the buffer, unless the buffer is full or slot doesn't come straight
+                   after the ones already in it. Errors are remembered, and commit() fails because of them
+----------------------------------------------------------------------------- */
+void SlotWriter::write(uint64_t slot, const Account& acc) {
+	if(held && (slot != first + held || (held + 1) * sizeof(Account) > buffer.size())) writeOut();
+	if(!held) first = slot;
+	memcpy(&buffer[held * sizeof(Account)], &acc, sizeof(Account));
+	held++;
+}
+
+//Writes the slots in the buffer out to where they go in the file
+void SlotWriter::writeOut() {
+	if(fd >= 0 && !failed && held) {
+		off_t offset = sizeof(DBHeader) + first * sizeof(Account);
+		if(!pwriteAll(fd, buffer.data(), held * sizeof(Account), offset)) failed = true;
+	}
+	held = 0;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          SlotWriter::commit()
+DESCRIPTION:       Syncs the slots that were written, then gives the file count slots and the generation
+RETURNS:           true if it's all on disk, false otherwise
+NOTES:             The file is closed either way
+----------------------------------------------------------------------------- */
+bool SlotWriter::commit(uint64_t count, uint64_t generation) {
+	if(fd < 0) return false;
+	writeOut();
+	DBHeader header = DBHeader();
+	memcpy(header.magic, DB_MAGIC, DB_MAGIC_LENGTH);
+	header.version = DB_VERSION;
+	header.recordSize = sizeof(Account);
+	header.count = count;
+	header.generation = generation;
+	bool written = !failed && !fdatasync(fd) && pwriteAll(fd, (const char*) &header, sizeof(header), 0)
+		&& !fdatasync(fd);
+	close();
+	return written;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          SlotWriter::close()
+DESCRIPTION:       Stops writing. Slots that were already written stay written, but the header doesn't change
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void SlotWriter::close() {
+	if(fd >= 0) ::close(fd);
+	fd = -1;
+	vector<char>().swap(buffer);
+	held = 0;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedDatabase::open()
+DESCRIPTION:       Maps a binary database file into memory and checks that its header
+                   matches the version and record layout of this program
+RETURNS:           true if the file was mapped, false otherwise
+----------------------------------------------------------------------------- */
+bool MappedDatabase::open(const char* fileName) {
+	close();
+	if(!file.open(fileName)) return false;
+
+	const DBHeader* header = (const DBHeader*) file.data();
+	if(file.size() < sizeof(DBHeader) || memcmp(header->magic, DB_MAGIC, DB_MAGIC_LENGTH)
+		|| header->version != DB_VERSION || header->recordSize != sizeof(Account)
+		|| header->count > (file.size() - sizeof(DBHeader)) / sizeof(Account)) {
+		close();
+		return false;
+	}
+
+	records = (const Account*) (header + 1);
+	count = header->count;
+	saves = header->generation;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedDatabase::close()
+DESCRIPTION:       Unmaps the database file, if there is one
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void MappedDatabase::close() {
+	file.close();
+	records = nullptr;
+	count = 0;
+	saves = 0;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          isBinaryDatabase()
+DESCRIPTION:       Checks whether a file starts with the binary database magic number
+RETURNS:           true if the file is a binary database, false otherwise
+----------------------------------------------------------------------------- */
+bool isBinaryDatabase(const char* fileName) {
+	char magic[DB_MAGIC_LENGTH];
+	ifstream input(fileName, ios::binary);
+	if(!input.read(magic, DB_MAGIC_LENGTH)) return false;
+	return !memcmp(magic, DB_MAGIC, DB_MAGIC_LENGTH);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readDatabase()
+DESCRIPTION:       Loads a database file in whichever format it was written in
+RETURNS:           true if the file was loaded, false otherwise
+NOTES:             The format the file was in is stored in format
+                   threads is the most threads to parse text files with
+----------------------------------------------------------------------------- */
+bool readDatabase(const char* fileName, AccountTable* people, DBFormat* format, char* error,
+                  unsigned int threads) {
+	if(isBinaryDatabase(fileName)) {
+		*format = DB_BINARY;
+		return readBinaryDatabase(fileName, people, error);
+	}
+	*format = DB_TEXT;
+	return readTextDatabase(fileName, people, error, threads);
+}
+
+//Splits the next line off of the text between *pos and end, without the line ending or surrounding blanks
+//Returns false if there are no lines left
+static bool nextLine(const char** pos, const char* end, const char** line, const char** lineEnd) {
+	if(*pos >= end) return false;
+	const char* start = *pos;
+	const char* newline = (const char*) memchr(start, '\n', end - start);
+	const char* stop = newline ? newline : end;
+	*pos = newline ? newline + 1 : end;
+
+	while(start < stop && (*start == ' ' || *start == '\t')) start++;
+	while(stop > start && (stop[-1] == '\r' || stop[-1] == ' ' || stop[-1] == '\t')) stop--;
+	*line = start;
+	*lineEnd = stop;
+	return true;
+}
+
+//Copies a line into a string field of at most max characters
+static bool parseString(const char* line, const char* lineEnd, char* field, unsigned int max) {
+	size_t length = lineEnd - line;
+	if(!length || length > max) return false;
+	memcpy(field, line, length);
+	field[length] = '\0';
+	return true;
+}
+
+//Converts a line of digits into an unsigned int, refusing anything which doesn't fit
+static bool parseUnsigned(const char* line, const char* lineEnd, unsigned int* value) {
+	if(line == lineEnd || lineEnd - line > 10) return false;
+	unsigned long long result = 0;
+	for(; line < lineEnd; line++) {
+		unsigned int digit = (unsigned char) *line - '0';
+		if(digit > 9) return false;
+		result = result * 10 + digit;
+	}
+	if(result > 0xFFFFFFFFull) return false;
+	*value = result;
+	return true;
+}
+
+static bool parseAccountNumber(const char* line, const char* lineEnd, char* number, AccKey* key) {
+	if(lineEnd - line != ACC_NUM_LENGTH) return false;
+	//Plain ASCII checks - the locale aware versions are much slower
+	for(int i = 0; i < ACC_NUM_LENGTH; i++) {
+		char c = line[i];
+		if(c >= 'a' && c <= 'z') c -= 'a' - 'A';
+		if(!((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z'))) return false;
+		number[i] = c;
+	}
+	number[ACC_NUM_LENGTH] = '\0';
+	*key = packAccNum(number);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parseTextDatabase()
+DESCRIPTION:       Parses text database records out of the characters between begin and end
+                   and adds them to people
+RETURNS:           true if every record was valid, false otherwise
+NOTES:             Records may be separated by any number of blank lines.
+                   Balances can have an exponent, as in files the first version of bankacct saved (see parseCents()).
+                   If a record is bad, the number of the line it went wrong on (counting begin as line 1)
+                   is stored in errorLine
+----------------------------------------------------------------------------- */
+bool parseTextDatabase(const char* begin, const char* end, AccountTable* people,
+                       unsigned long* errorLine, char* error) {
+	//Names of each of the lines of a record, for error messages
+	static const char* fields[] = {"first name", "last name", "middle initial", "social security number",
+	                               "area code", "phone number", "balance", "account number", "password"};
+	const char* pos = begin;
+	const char *line, *lineEnd;
+	unsigned long lineNum = 0;
+	//Once we've seen a few records, guess how many there are in total so the table only grows once
+	unsigned int parsed = 0;
+
+	while(true) {
+		if(++parsed == 64) people->reserve(people->size() + (end - pos) / ((pos - begin) / 63) * 11 / 10);
+
+		//Find the start of the next record
+		bool found = false;
+		while(nextLine(&pos, end, &line, &lineEnd)) {
+			lineNum++;
+			if(line != lineEnd) {
+				found = true;
+				break;
+			}
+		}
+		if(!found) return true;
+
+		//It starts zeroed so the unused ends of the strings are clean if we write a binary file later
+		Account person = Account();
+		unsigned int nameLength = 0;
+		for(int field = 0; field < 9; field++) {
+			if(field && !nextLine(&pos, end, &line, &lineEnd)) {
+				*errorLine = lineNum + 1;
+				snprintf(error, DB_ERROR_LENGTH, "record ends before %s", fields[field]);
+				return false;
+			}
+			if(field) lineNum++;
+
+			bool valid = false;
+			switch(field) {
+				case 0:
+					valid = parseString(line, lineEnd, person.first, FIRST_NAME_LENGTH);
+					nameLength = lineEnd - line + 4;
+					break;
+				case 1:
+					valid = parseString(line, lineEnd, person.last, LAST_NAME_LENGTH);
+					nameLength += lineEnd - line;
+					break;
+				case 2:
+					valid = lineEnd - line == 1;
+					if(valid) person.middle = *line;
+					break;
+				case 3:
+					valid = parseUnsigned(line, lineEnd, &person.social);
+					break;
+				case 4:
+					valid = parseUnsigned(line, lineEnd, &person.area);
+					break;
+				case 5:
+					valid = parseUnsigned(line, lineEnd, &person.phone);
+					break;
+				case 6:
+					valid = parseCents(line, lineEnd, &person.balance);
+					break;
+				case 7:
+					valid = parseAccountNumber(line, lineEnd, person.number, &person.key);
+					break;
+				case 8:
+					valid = parseString(line, lineEnd, person.password, PASS_LENGTH);
+					break;
+			}
+			if(!valid) {
+				*errorLine = lineNum;
+				snprintf(error, DB_ERROR_LENGTH, "bad %s \"%.*s\"", fields[field],
+					(int) (lineEnd - line > 20 ? 20 : lineEnd - line), line);
+				return false;
+			}
+		}
+		person.nameLength = nameLength;
+		people->append(person);
+	}
+}
+
+//Finds the first blank line at or after pos, so that a file can be split between records
+//Returns end if there isn't one
+static const char* nextRecordBoundary(const char* pos, const char* begin, const char* end) {
+	//Back up to the start of the line we're in the middle of
+	while(pos > begin && pos[-1] != '\n') pos--;
+	const char *line, *lineEnd, *next = pos;
+	while(next < end) {
+		pos = next;
+		nextLine(&next, end, &line, &lineEnd);
+		if(line == lineEnd) return pos;
+	}
+	return end;
+}
+
+//Parses the records between begin and end of the text file that starts at file into people,
+//splitting them between up to threads threads if there are enough of them
+static bool parseTextChunks(const char* file, const char* begin, const char* end, AccountTable* people,
+                            unsigned int threads, char* error) {
+	char message[DB_ERROR_LENGTH];
+	unsigned long errorLine;
+
+	//Small files aren't worth starting threads for
+	if(threads > (end - begin) / TEXT_CHUNK_MIN) threads = (end - begin) / TEXT_CHUNK_MIN;
+	if(threads <= 1) {
+		if(parseTextDatabase(begin, end, people, &errorLine, message)) return true;
+		//Work out which line of the file the bad line was on
+		for(const char* pos = file; (pos = (const char*) memchr(pos, '\n', begin - pos)); pos++) errorLine++;
+		snprintf(error, DB_ERROR_LENGTH, "line %lu: %.80s", errorLine, message);
+		return false;
+	}
+
+	//Split the text into roughly equal chunks, moving each split forward to the next record
+	vector<const char*> splits(threads + 1);
+	splits[0] = begin;
+	splits[threads] = end;
+	for(unsigned int i = 1; i < threads; i++) {
+		splits[i] = nextRecordBoundary(begin + (end - begin) / threads * i, begin, end);
+		if(splits[i] < splits[i - 1]) splits[i] = splits[i - 1];
+	}
+
+	//The first chunk goes straight into people, so only the others have to be copied over afterwards
+	vector<AccountTable> chunks(threads);
+	vector<AccountTable*> outputs(threads);
+	outputs[0] = people;
+	for(unsigned int i = 1; i < threads; i++) outputs[i] = &chunks[i];
+	vector<char> valid(threads);
+	vector<unsigned long> errorLines(threads);
+	vector<char> messages(threads * DB_ERROR_LENGTH);
+	vector<thread> workers;
+	for(unsigned int i = 0; i < threads; i++) {
+		workers.push_back(thread([&, i]() {
+			valid[i] = parseTextDatabase(splits[i], splits[i + 1], outputs[i], &errorLines[i],
+			                             &messages[i * DB_ERROR_LENGTH]);
+		}));
+	}
+	for(thread& worker : workers) worker.join();
+
+	size_t total = 0;
+	for(unsigned int i = 0; i < threads; i++) {
+		if(!valid[i]) {
+			errorLine = errorLines[i];
+			for(const char* pos = file; (pos = (const char*) memchr(pos, '\n', splits[i] - pos)); pos++)
+				errorLine++;
+			snprintf(error, DB_ERROR_LENGTH, "line %lu: %.80s", errorLine, &messages[i * DB_ERROR_LENGTH]);
+			return false;
+		}
+		total += outputs[i]->size();
+	}
+
+	people->reserve(total);
+	//take() gives each chunk's memory back as it goes, rather than holding two copies of everything
+	for(unsigned int i = 1; i < threads; i++) people->take(&chunks[i]);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readTextDatabase()
+DESCRIPTION:       Loads the accounts from a text database file
+RETURNS:           true if the file was loaded, false otherwise
+NOTES:             Large files are split into chunks on the blank lines between records
+                   and each chunk is parsed by its own thread, up to threads threads
+----------------------------------------------------------------------------- */
+bool readTextDatabase(const char* fileName, AccountTable* people, char* error, unsigned int threads) {
+	MappedFile file;
+	if(!file.open(fileName)) {
+		snprintf(error, DB_ERROR_LENGTH, "could not be opened");
+		return false;
+	}
+	return parseTextChunks(file.data(), file.data(), file.data() + file.size(), people, threads, error);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readBinaryDatabase()
+DESCRIPTION:       Loads the accounts from a binary database file
+RETURNS:           true if the file was loaded, false otherwise
+NOTES:             The records are split into the table straight out of the mapping - no fields are parsed
+----------------------------------------------------------------------------- */
+bool readBinaryDatabase(const char* fileName, AccountTable* people, char* error) {
+	DatabaseReader reader;
+	if(!reader.open(fileName, error)) return false;
+	if(reader.fileFormat() == DB_BINARY) return reader.read(people, nullptr, SIZE_MAX, 1, error);
+	snprintf(error, DB_ERROR_LENGTH, "is not a binary database");
+	return false;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          DatabaseReader::open()
+DESCRIPTION:       Opens a database file in whichever format it was written in, ready to read it from the start
+RETURNS:           true if it was opened, false otherwise
+----------------------------------------------------------------------------- */
+bool DatabaseReader::open(const char* fileName, char* error) {
+	close();
+	if(isBinaryDatabase(fileName)) {
+		format = DB_BINARY;
+		if(binary.open(fileName) && binary.size() <= UINT32_MAX) return true;
+		snprintf(error, DB_ERROR_LENGTH, "is damaged or from a different version of bankacct");
+	} else {
+		format = DB_TEXT;
+		if(text.open(fileName)) return true;
+		snprintf(error, DB_ERROR_LENGTH, "could not be opened");
+	}
+	close();
+	return false;
+}
+
+void DatabaseReader::close() {
+	text.close();
+	binary.close();
+	done = 0;
+	accounts = 0;
+	order = nullptr;
+	names = nullptr;
+	rows = 0;
+	vector<bool>().swap(seen);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          DatabaseReader::setOrder()
+DESCRIPTION:       Has a binary file read in the order of slots, rows slots long, instead of in slot order,
+                   and starts again from the beginning. Each row's first and last names are at the NameRefs
+                   in names, two to a row, which are in the arena of the table it's read into already.
+                   Null slots goes back to reading in slot order
+RETURNS:           Void function
+NOTES:             If the slots and names turn out not to fit the file, read() fails
+----------------------------------------------------------------------------- */
+void DatabaseReader::setOrder(const uint32_t* slots, const NameRef* names, uint64_t rows) {
+	done = 0;
+	accounts = 0;
+	order = slots;
+	this->names = slots ? names : nullptr;
+	this->rows = slots ? rows : 0;
+	seen.assign(slots ? binary.size() : 0, false);
+}
+
+//How far there is to go: bytes of a text file, slots of a binary file, or rows of the order
+uint64_t DatabaseReader::total() const {
+	if(format == DB_TEXT) return text.size();
+	return order ? rows : binary.size();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          DatabaseReader::read()
+DESCRIPTION:       Adds about the next count accounts in the file to people, and the slot of each one
+                   to slots if it's a binary file and slots isn't null
+RETURNS:           true if they were read, false otherwise
+NOTES:             A text file is read to the end of the record count accounts is guessed to get to,
+                   on up to threads threads. Everything is read if count is SIZE_MAX
+----------------------------------------------------------------------------- */
+bool DatabaseReader::read(AccountTable* people, vector<uint32_t>* slots, size_t count, unsigned int threads,
+                          char* error) {
+	size_t before = people->size();
+	if(format == DB_TEXT) {
+		const char* begin = text.data();
+		const char* end = begin + text.size();
+		const char* from = begin + done;
+		//Guess how far count accounts go from how long the ones so far were
+		uint64_t length = accounts ? done / accounts : TEXT_ACCOUNT_GUESS;
+		const char* to = end;
+		if(length && count < (uint64_t) (end - from) / length) to = max(from, nextRecordBoundary(from + count * length, begin, end));
+		if(!parseTextChunks(begin, from, to, people, threads, error)) return false;
+		//Make room for the rest once there's a better idea of how many there are, so the table isn't grown every batch
+		if(!accounts && people->size() > before && to < end) {
+			people->reserve(people->size() + (end - to) / ((to - from) / (people->size() - before)) * 5 / 4);
+		}
+		done = to - begin;
+		accounts += people->size() - before;
+		return true;
+	}
+
+	uint64_t stop = count < total() - done ? done + count : total();
+	if(!done) {
+		people->reserve(people->size() + total());
+		if(slots) slots->reserve(slots->size() + total());
+	}
+	if(!order) {
+		for(; done < stop; done++) {
+			if(isFreeSlot(binary.begin()[done])) continue;
+			people->append(binary.begin()[done]);
+			if(slots) slots->push_back(done);
+		}
+		accounts += people->size() - before;
+		return true;
+	}
+
+	//Every row has to be in a different slot with an account in it, and have names that are in the arena
+	size_t nameBytes = people->nameArena().block().size();
+	for(; done < stop; done++) {
+		//The slots jump about, so the hardware won't see the next ones coming
+		if(done + DB_PREFETCH_AHEAD < rows && order[done + DB_PREFETCH_AHEAD] < binary.size()) {
+			const char* ahead = (const char*) (binary.begin() + order[done + DB_PREFETCH_AHEAD]);
+			for(size_t offset = 0; offset < sizeof(Account); offset += 64) __builtin_prefetch(ahead + offset);
+		}
+		uint32_t slot = order[done];
+		NameRef first = names[done * 2], last = names[done * 2 + 1];
+		if(slot >= binary.size() || seen[slot] || isFreeSlot(binary.begin()[slot]) || first >= nameBytes
+			|| last >= nameBytes) {
+			snprintf(error, DB_ERROR_LENGTH, "doesn't match the order it was to be read in");
+			return false;
+		}
+		seen[slot] = true;
+		people->append(binary.begin()[slot], first, last);
+		if(slots) slots->push_back(slot);
+	}
+	accounts += people->size() - before;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readDatabaseGeneration()
+DESCRIPTION:       Reads how many times a binary database file has been saved
+RETURNS:           true if fileName is a binary database file, false otherwise
+----------------------------------------------------------------------------- */
+bool readDatabaseGeneration(const char* fileName, uint64_t* generation) {
+	DBHeader header;
+	ifstream input(fileName, ios::binary);
+	if(!input.read((char*) &header, sizeof(header)) || memcmp(header.magic, DB_MAGIC, DB_MAGIC_LENGTH)) return false;
+	*generation = header.generation;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          writeDatabase()
+DESCRIPTION:       Writes the accounts to a database file in the given format
+RETURNS:           true if the file was written, false otherwise
+----------------------------------------------------------------------------- */
+bool writeDatabase(const char* fileName, const AccountTable* people, DBFormat format) {
+	if(format == DB_BINARY) return writeBinaryDatabase(fileName, people);
+	return writeTextDatabase(fileName, people);
+}
+
+//Writes number out in decimal
+static void writeNumber(FileWriter& out, unsigned long long number) {
+	char digits[20];
+	int start = sizeof(digits);
+	do {
+		digits[--start] = '0' + number % 10;
+		number /= 10;
+	} while(number);
+	out.write(digits + start, sizeof(digits) - start);
+}
+
+//Writes a line of text
+static void writeLine(FileWriter& out, const char* text) {
+	out.write(text, strlen(text));
+	out.put('\n');
+}
+
+//Writes the nine lines of one text record
+static void writeTextRecord(FileWriter& out, const char* first, const char* last, char middle, unsigned int social,
+                            unsigned int area, unsigned int phone, Cents balance, const char* number,
+                            const char* password) {
+	writeLine(out, first);
+	writeLine(out, last);
+	out.put(middle);
+	out.put('\n');
+	writeNumber(out, social);
+	out.put('\n');
+	writeNumber(out, area);
+	out.put('\n');
+	writeNumber(out, phone);
+	out.put('\n');
+	//The same as formatCents() gives
+	unsigned long long size = balance < 0 ? 0 - (unsigned long long) balance : balance;
+	if(balance < 0) out.put('-');
+	writeNumber(out, size / CENTS_PER_DOLLAR);
+	out.put('.');
+	out.put('0' + size % CENTS_PER_DOLLAR / 10);
+	out.put('0' + size % 10);
+	out.put('\n');
+	writeLine(out, number);
+	writeLine(out, password);
+	out.put('\n');
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          writeTextDatabase()
+DESCRIPTION:       Writes the accounts to a text database file
+RETURNS:           true if the file was written, false otherwise
+NOTES:             If it wasn't, the file is left as it was. See FileWriter
+----------------------------------------------------------------------------- */
+bool writeTextDatabase(const char* fileName, const AccountTable* people) {
+	FileWriter out;
+	if(!out.open(fileName)) return false;
+	for(size_t i = 0; i < people->size(); i++) {
+		const AccountDetails& acc = people->detail(i);
+		writeTextRecord(out, people->firstName(i), people->lastName(i), acc.middle, acc.social, acc.area,
+			acc.phone, people->balance(i), acc.number, acc.password);
+	}
+	return out.commit();
+}
+
+bool writeTextDatabase(const char* fileName, const Account* records, uint64_t count) {
+	FileWriter out;
+	if(!out.open(fileName)) return false;
+	for(uint64_t i = 0; i < count; i++) {
+		const Account& acc = records[i];
+		if(isFreeSlot(acc)) continue;
+		writeTextRecord(out, acc.first, acc.last, acc.middle, acc.social, acc.area, acc.phone,
+			acc.balance, acc.number, acc.password);
+	}
+	return out.commit();
+}
+
+//Writes the header of a binary database holding count slots
+static void writeBinaryHeader(FileWriter& out, uint64_t count, uint64_t generation) {
+	DBHeader header = DBHeader();
+	memcpy(header.magic, DB_MAGIC, DB_MAGIC_LENGTH);
+	header.version = DB_VERSION;
+	header.recordSize = sizeof(Account);
+	header.count = count;
+	header.generation = generation;
+	out.write(&header, sizeof(header));
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          writeBinaryDatabase()
+DESCRIPTION:       Writes the accounts to a binary database file
+RETURNS:           true if the file was written, false otherwise
+NOTES:             If it wasn't, the file is left as it was. See FileWriter
+----------------------------------------------------------------------------- */
+bool writeBinaryDatabase(const char* fileName, const AccountTable* people) {
+	return writeBinaryDatabase(fileName, people, nullptr, people->size(), 0);
+}
+
+//Puts row i in slots[i] of count slots, and leaves the rest free. Without slots, row i goes in slot i
+bool writeBinaryDatabase(const char* fileName, const AccountTable* people, const vector<uint32_t>* slots,
+                         uint64_t count, uint64_t generation) {
+	vector<uint32_t> rows;
+	if(slots) {
+		rows.assign(count, UINT32_MAX);
+		for(size_t i = 0; i < people->size(); i++) rows[(*slots)[i]] = i;
+	}
+	FileWriter out;
+	if(!out.open(fileName)) return false;
+	writeBinaryHeader(out, count, generation);
+	//The file holds whole records, so put each one back together
+	Account free = Account();
+	free.key = ACC_KEY_INVALID;
+	for(uint64_t slot = 0; slot < count; slot++) {
+		uint32_t row = slots ? rows[slot] : slot;
+		if(row == UINT32_MAX) {
+			out.write(&free, sizeof(free));
+			continue;
+		}
+		Account acc = people->get(row);
+		out.write(&acc, sizeof(acc));
+	}
+	return out.commit();
+}
+
+bool writeBinaryDatabase(const char* fileName, const Account* records, uint64_t count) {
+	FileWriter out;
+	if(!out.open(fileName)) return false;
+	writeBinaryHeader(out, count, 0);
+	out.write(records, count * sizeof(Account));
+	return out.commit();
+}
@@ -0,0 +1,208 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              database.h
+
+DESCRIPTION:       Reading and writing of database files, in both the text and binary formats
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __DATABASE_H__
+#define __DATABASE_H__
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <stdint.h>
+#include "account.h"
+#include "accounttable.h"
+
+//Binary database format
+//A DBHeader followed by count slots, each an Account record exactly as it's laid out in memory.
+//An account keeps its slot from one save to the next, so a save only has to write the slots that changed.
+//A slot whose key is ACC_KEY_INVALID is free
+//Bump DB_VERSION whenever the layout of DBHeader or Account changes
+#define DB_MAGIC "BANKACDB"
+#define DB_MAGIC_LENGTH 8
+#define DB_VERSION 4
+
+#define DB_ERROR_LENGTH 100
+
+//Text databases are only split between threads if each thread gets at least this many bytes
+#define TEXT_CHUNK_MIN (1 << 20)
+//How many bytes a DatabaseReader guesses each account in a text file takes, until it's read some
+#define TEXT_ACCOUNT_GUESS 64
+//How many accounts ahead of the one being read a DatabaseReader fetches, when it's given the order to read them in
+#define DB_PREFETCH_AHEAD 16
+
+//Databases are written this many bytes at a time
+#define DB_WRITE_BUFFER (4 << 20)
+//Added to a file's name while a new version of it is being written
+#define DB_TEMP_SUFFIX ".saving"
+
+using namespace std;
+
+enum DBFormat {
+	DB_TEXT,
+	DB_BINARY
+};
+
+struct DBHeader {
+	char magic[DB_MAGIC_LENGTH];
+	uint32_t version;
+	//sizeof(Account) of the program which wrote the file
+	uint32_t recordSize;
+	uint64_t count;
+	//Goes up by one every time the file is saved, so the journal can tell which save it came after
+	uint64_t generation;
+};
+
+//A read-only mapping of a whole file
+class MappedFile {
+	private:
+		void* map;
+		size_t length;
+	public:
+		MappedFile() : map(nullptr), length(0) {}
+		~MappedFile() { close(); }
+
+		bool open(const char*);
+		void close();
+
+		const char* data() const { return (const char*) map; }
+		size_t size() const { return length; }
+};
+
+//Writes a new version of a file. Everything goes through one big buffer into a temporary file next to it,
+//which is synced once and renamed over the real file by commit(). Until then the old file is left as it was,
+//so a crash part way through writing can't damage it. If commit() isn't called, the temporary file is removed
+class FileWriter {
+	private:
+		string fileName;
+		string tempName;
+		int fd;
+		vector<char> buffer;
+		size_t used;
+		bool failed;
+
+		void writeOut(const char*, size_t);
+	public:
+		FileWriter() : fd(-1), used(0), failed(false) {}
+		~FileWriter() { abandon(); }
+
+		bool open(const char*);
+		bool commit();
+		void abandon();
+
+		void write(const void* data, size_t length) {
+			if(length > buffer.size() - used) writeOut((const char*) data, length);
+			else {
+				memcpy(&buffer[used], data, length);
+				used += length;
+			}
+		}
+		void put(char c) {
+			if(used == buffer.size()) writeOut(&c, 1);
+			else buffer[used++] = c;
+		}
+};
+
+//Writes slots of a binary database file in place. Slots next to each other go out in one write.
+//commit() syncs them, then writes the header with the new slot count and generation and syncs that.
+//Until the header is written, the file's generation is still the one the journal was started on,
+//so a crash part way through is put right by replaying the journal over whatever slots made it
+class SlotWriter {
+	private:
+		int fd;
+		vector<char> buffer;
+		//The slot the buffer starts at, and how many are in it
+		uint64_t first;
+		size_t held;
+		bool failed;
+
+		void writeOut();
+	public:
+		SlotWriter() : fd(-1), first(0), held(0), failed(false) {}
+		~SlotWriter() { close(); }
+
+		bool open(const char*);
+		void write(uint64_t, const Account&);
+		bool commit(uint64_t, uint64_t);
+		void close();
+};
+
+//A read-only mapping of a binary database file
+//The records can be used in place without copying or parsing them. Some of them may be free slots
+class MappedDatabase {
+	private:
+		MappedFile file;
+		const Account* records;
+		uint64_t count;
+		uint64_t saves;
+	public:
+		MappedDatabase() : records(nullptr), count(0), saves(0) {}
+
+		bool open(const char*);
+		void close();
+
+		const Account* begin() const { return records; }
+		const Account* end() const { return records + count; }
+		uint64_t size() const { return count; }
+		uint64_t generation() const { return saves; }
+};
+
+inline bool isFreeSlot(const Account& acc) { return acc.key == ACC_KEY_INVALID; }
+
+//Reads a database file a batch of accounts at a time, so the ones read so far can be used while the rest are read.
+//Text files are split on the blank lines between records. Binary files are read a run of slots at a time,
+//or in the order setOrder() gives, with names that are in the table's NameArena already
+class DatabaseReader {
+	private:
+		DBFormat format;
+		MappedFile text;
+		MappedDatabase binary;
+		//How far it's got: bytes of a text file, slots of a binary file, or rows of the order
+		uint64_t done;
+		//Accounts read so far
+		uint64_t accounts;
+		//From setOrder(). Which slot each row is in, its first and last NameRef, and which slots have been read
+		const uint32_t* order;
+		const NameRef* names;
+		uint64_t rows;
+		vector<bool> seen;
+
+		uint64_t total() const;
+	public:
+		DatabaseReader() : format(DB_TEXT), done(0), accounts(0), order(nullptr), names(nullptr), rows(0) {}
+
+		bool open(const char*, char*);
+		void close();
+		void setOrder(const uint32_t*, const NameRef*, uint64_t);
+		bool read(AccountTable*, vector<uint32_t>*, size_t, unsigned int, char*);
+
+		DBFormat fileFormat() const { return format; }
+		bool finished() const { return done == total(); }
+		//How far through the file it is, out of 1000
+		unsigned int progress() const { return total() ? done * 1000 / total() : 1000; }
+		//Binary files only. How many slots the file has, free ones included, and its generation
+		uint64_t slotCount() const { return binary.size(); }
+		uint64_t generation() const { return binary.generation(); }
+};
+
+//The functions which read databases take a buffer of DB_ERROR_LENGTH characters
+//which they fill with the reason the database could not be read
+bool isBinaryDatabase(const char*);
+bool readDatabase(const char*, AccountTable*, DBFormat*, char*, unsigned int);
+bool readTextDatabase(const char*, AccountTable*, char*, unsigned int);
+bool parseTextDatabase(const char*, const char*, AccountTable*, unsigned long*, char*);
+bool readBinaryDatabase(const char*, AccountTable*, char*);
+bool readDatabaseGeneration(const char*, uint64_t*);
+bool writeDatabase(const char*, const AccountTable*, DBFormat);
+bool writeTextDatabase(const char*, const AccountTable*);
+bool writeTextDatabase(const char*, const Account*, uint64_t);
+bool writeBinaryDatabase(const char*, const AccountTable*);
+bool writeBinaryDatabase(const char*, const AccountTable*, const vector<uint32_t>*, uint64_t, uint64_t);
+bool writeBinaryDatabase(const char*, const Account*, uint64_t);
+
+#endif
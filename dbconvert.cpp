@@ -0,0 +1,67 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              dbconvert.cpp
+	DESCRIPTION:       Converts database files between the text and binary formats
+	USAGE:             dbconvert [-t | -b] input output
+	                   -t writes a text database, -b writes a binary database
+	                   Without either, the output is in the opposite format of the input
+	COMPILER:          Built on g++ with c++11
+	Exit Codes:
+		- 0: All good
+		- 1: Bad arguments
+		- 2: Could not load input file
+		- 3: Could not write output file
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include "database.h"
+
+using namespace std;
+
+int main(int argc, char** argv) {
+	int arg = 1;
+	bool forced = false;
+	DBFormat outFormat = DB_TEXT;
+	if(argc == 4 && (!strcmp(argv[1], "-t") || !strcmp(argv[1], "-b"))) {
+		forced = true;
+		outFormat = argv[1][1] == 'b' ? DB_BINARY : DB_TEXT;
+		arg++;
+	}
+	if(argc - arg != 2) {
+		fprintf(stderr, "Usage: %s [-t | -b] input output\n", argv[0]);
+		return 1;
+	}
+	const char* inName = argv[arg];
+	const char* outName = argv[arg + 1];
+
+	bool written;
+	if(isBinaryDatabase(inName)) {
+		if(!forced) outFormat = DB_TEXT;
+		//Binary input can be used straight out of the mapping
+		MappedDatabase db;
+		if(!db.open(inName)) {
+			fprintf(stderr, "%s: could not load %s\n", argv[0], inName);
+			return 2;
+		}
+		if(outFormat == DB_BINARY) written = writeBinaryDatabase(outName, db.begin(), db.size());
+		else written = writeTextDatabase(outName, db.begin(), db.size());
+	} else {
+		if(!forced) outFormat = DB_BINARY;
+		AccountTable people;
+		char error[DB_ERROR_LENGTH];
+		if(!readTextDatabase(inName, &people, error, thread::hardware_concurrency())) {
+			fprintf(stderr, "%s: %s %s\n", argv[0], inName, error);
+			return 2;
+		}
+		written = writeDatabase(outName, &people, outFormat);
+	}
+
+	if(!written) {
+		fprintf(stderr, "%s: could not write %s\n", argv[0], outName);
+		return 3;
+	}
+	return 0;
+}
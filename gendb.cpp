@@ -0,0 +1,52 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              gendb.cpp
+	DESCRIPTION:       Makes a text database full of made up accounts, and optionally a batch mode
+	                   transactions file to go with it
+	USAGE:             gendb count database [transactions count]
+	                   Writes count accounts to database, then count transactions to transactions.
+	                   The same counts always give the same files
+	COMPILER:          Built on g++ with c++11
+	Exit Codes:
+		- 0: All good
+		- 1: Bad arguments
+		- 2: Could not write the database
+		- 3: Could not write the transactions
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstdlib>
+#include "database.h"
+#include "generate.h"
+
+using namespace std;
+
+//Reads a count from the command line. false if it isn't one
+bool readCount(const char* text, size_t* count) {
+	char* end;
+	unsigned long long value = strtoull(text, &end, 10);
+	if(*end || !*text || value > UINT32_MAX) return false;
+	*count = value;
+	return true;
+}
+
+int main(int argc, char** argv) {
+	size_t accounts, transactions = 0;
+	if((argc != 3 && argc != 5) || !readCount(argv[1], &accounts) || (argc == 5 && !readCount(argv[4], &transactions))) {
+		fprintf(stderr, "Usage: %s count database [transactions count]\n", argv[0]);
+		return 1;
+	}
+
+	AccountTable people;
+	generateAccounts(&people, accounts, GENERATE_SEED);
+	if(!writeTextDatabase(argv[2], &people)) {
+		fprintf(stderr, "%s: Could not write \"%s\"\n", argv[0], argv[2]);
+		return 2;
+	}
+	if(argc == 5 && !generateTransactions(argv[3], &people, transactions, GENERATE_SEED + 1)) {
+		fprintf(stderr, "%s: Could not write \"%s\"\n", argv[0], argv[3]);
+		return 3;
+	}
+	return 0;
+}
@@ -0,0 +1,140 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              generate.cpp
+	DESCRIPTION:       Makes up accounts and transactions. Names come from short lists, like real ones
+	                   come from a small set of common names, and account numbers are all different
+	                   but come out in no particular order, like a database that hasn't been sorted yet
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include "generate.h"
+
+using namespace std;
+
+//Every possible account number
+#define KEY_SPACE 60466176u
+//Stepping through the numbers this far at a time visits every one of them once,
+//since it shares no factors with KEY_SPACE (which only has 2s and 3s)
+#define KEY_STRIDE 40503001u
+
+static const char* firstNames[] = {
+	"James", "Mary", "Robert", "Patricia", "John", "Jennifer", "Michael", "Linda", "David", "Elizabeth",
+	"William", "Barbara", "Richard", "Susan", "Joseph", "Jessica", "Thomas", "Sarah", "Charles", "Karen",
+	"Christopher", "Lisa", "Daniel", "Nancy", "Matthew", "Betty", "Anthony", "Margaret", "Mark", "Sandra",
+	"Donald", "Ashley", "Steven", "Kimberly", "Paul", "Emily", "Andrew", "Donna", "Joshua", "Michelle",
+	"Kenneth", "Carol", "Kevin", "Amanda", "Brian", "Dorothy", "George", "Melissa", "Timothy", "Deborah",
+	"Ronald", "Stephanie", "Edward", "Rebecca", "Jason", "Sharon", "Jeffrey", "Laura", "Ryan", "Cynthia",
+	"Jacob", "Kathleen", "Gary", "Amy", "Nicholas", "Angela", "Eric", "Shirley", "Jonathan", "Anna",
+	"Stephen", "Brenda", "Larry", "Pamela", "Justin", "Emma", "Scott", "Nicole", "Brandon", "Helen",
+	"Benjamin", "Samantha", "Samuel", "Katherine", "Gregory", "Christine", "Alexander", "Debra", "Frank", "Rachel",
+	"Raymond", "Carolyn", "Patrick", "Janet", "Jack", "Catherine", "Dennis", "Maria", "Jerry", "Heather"
+};
+
+static const char* lastNames[] = {
+	"Smith", "Johnson", "Williams", "Brown", "Jones", "Garcia", "Miller", "Davis", "Rodriguez", "Martinez",
+	"Hernandez", "Lopez", "Gonzalez", "Wilson", "Anderson", "Thomas", "Taylor", "Moore", "Jackson", "Martin",
+	"Lee", "Perez", "Thompson", "White", "Harris", "Sanchez", "Clark", "Ramirez", "Lewis", "Robinson",
+	"Walker", "Young", "Allen", "King", "Wright", "Scott", "Torres", "Nguyen", "Hill", "Flores",
+	"Green", "Adams", "Nelson", "Baker", "Hall", "Rivera", "Campbell", "Mitchell", "Carter", "Roberts",
+	"Gomez", "Phillips", "Evans", "Turner", "Diaz", "Parker", "Cruz", "Edwards", "Collins", "Reyes",
+	"Stewart", "Morris", "Morales", "Murphy", "Cook", "Rogers", "Gutierrez", "Ortiz", "Morgan", "Cooper",
+	"Peterson", "Bailey", "Reed", "Kelly", "Howard", "Ramos", "Kim", "Cox", "Ward", "Richardson",
+	"Watson", "Brooks", "Chavez", "Wood", "James", "Bennett", "Gray", "Mendoza", "Ruiz", "Hughes",
+	"Price", "Alvarez", "Castillo", "Sanders", "Patel", "Myers", "Long", "Ross", "Foster", "Novotny"
+};
+
+#define FIRST_NAMES (sizeof(firstNames) / sizeof(firstNames[0]))
+#define LAST_NAMES (sizeof(lastNames) / sizeof(lastNames[0]))
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          generatedKey()
+DESCRIPTION:       The account number of the i'th made up account
+RETURNS:           The key. Every i below KEY_SPACE gets a different one
+----------------------------------------------------------------------------- */
+AccKey generatedKey(size_t i) {
+	return ((uint64_t) i * KEY_STRIDE + 12345) % KEY_SPACE;
+}
+
+//Most people don't have much in the bank, and a few have a lot
+static Cents randomBalance(Random* random) {
+	uint32_t digits = 2 + random->below(8);
+	Cents limit = 1;
+	for(uint32_t i = 0; i < digits; i++) limit *= 10;
+	uint64_t high = random->next();
+	return (Cents) ((high << 32 | random->next()) % limit);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          generateAccounts()
+DESCRIPTION:       Adds count made up accounts to the end of people
+RETURNS:           Void function
+NOTES:             count can't be more than there are account numbers
+----------------------------------------------------------------------------- */
+void generateAccounts(AccountTable* people, size_t count, uint64_t seed) {
+	Random random(seed);
+	people->reserve(people->size() + count);
+	for(size_t i = 0; i < count && i < KEY_SPACE; i++) {
+		Account acc = Account();
+		strcpy(acc.first, firstNames[random.below(FIRST_NAMES)]);
+		strcpy(acc.last, lastNames[random.below(LAST_NAMES)]);
+		acc.middle = 'A' + random.below(26);
+		acc.social = 100000000 + random.below(900000000);
+		acc.area = 200 + random.below(800);
+		acc.phone = 2000000 + random.below(8000000);
+		acc.balance = randomBalance(&random);
+		acc.key = generatedKey(i);
+		unpackAccNum(acc.key, acc.number);
+		for(int c = 0; c < PASS_LENGTH; c++) {
+			uint32_t digit = random.below(36);
+			acc.password[c] = digit < 10 ? '0' + digit : 'A' + digit - 10;
+		}
+		acc.nameLength = strlen(acc.first) + strlen(acc.last) + 4;
+		people->append(acc);
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          generateTransactions()
+DESCRIPTION:       Writes count made up transactions against the accounts in people to the file fileName,
+                   in the format batch mode reads
+RETURNS:           true if the file was written, false otherwise
+NOTES:             Mostly deposits, withdrawals and transfers of a few hundred dollars at most, with the odd
+                   account opened or closed. Some withdrawals will be overdrafts, like in real life.
+                   New accounts get the numbers generatedKey() would give the accounts after people's
+----------------------------------------------------------------------------- */
+bool generateTransactions(const char* fileName, const AccountTable* people, size_t count, uint64_t seed) {
+	FILE* file = fopen(fileName, "w");
+	if(!file) return false;
+	if(people->empty()) count = 0;
+	Random random(seed);
+	size_t opened = 0;
+	char number[ACC_NUM_LENGTH + 1], other[ACC_NUM_LENGTH + 1];
+	for(size_t i = 0; i < count; i++) {
+		unpackAccNum(people->key(random.below(people->size())), number);
+		unsigned int dollars = random.below(500), cents = random.below(100);
+		uint32_t kind = random.below(10000);
+		if(kind < 4500) fprintf(file, "deposit %s %u.%02u\n", number, dollars, cents);
+		else if(kind < 8000) fprintf(file, "withdraw %s %u.%02u\n", number, dollars, cents);
+		else if(kind < 9990) {
+			unpackAccNum(people->key(random.below(people->size())), other);
+			fprintf(file, "transfer %s %s %u.%02u\n", number, other, dollars, cents);
+		} else if(kind < 9995) {
+			unpackAccNum(generatedKey(people->size() + opened++), other);
+			//One at a time, since the order arguments are worked out in isn't fixed
+			const char* first = firstNames[random.below(FIRST_NAMES)];
+			const char* last = lastNames[random.below(LAST_NAMES)];
+			char middle = 'A' + random.below(26);
+			unsigned int social = 100000000 + random.below(900000000);
+			unsigned int area = 200 + random.below(800);
+			unsigned int phone = 2000000 + random.below(8000000);
+			fprintf(file, "open %s %s %c %u %u %u %u.%02u %s PASSWD\n", first, last, middle, social, area, phone,
+				dollars, cents, other);
+		} else fprintf(file, "close %s\n", number);
+	}
+	bool written = !ferror(file);
+	if(fclose(file)) written = false;
+	return written;
+}
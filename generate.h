@@ -0,0 +1,45 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              generate.h
+
+DESCRIPTION:       Made up accounts and transactions, for benchmarks and for trying things out on big databases
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __GENERATE_H__
+#define __GENERATE_H__
+
+#include <stdint.h>
+#include <cstddef>
+#include "accounttable.h"
+
+//The same seed always gives the same accounts and transactions, so runs can be compared
+#define GENERATE_SEED 0x2545F4914F6CDD1Dull
+
+using namespace std;
+
+//A small, fast random number generator (PCG). Not for anything that needs to be unpredictable
+class Random {
+	private:
+		uint64_t state;
+	public:
+		Random(uint64_t seed) : state(seed) {}
+
+		uint32_t next() {
+			uint64_t old = state;
+			state = old * 6364136223846793005ull + 1442695040888963407ull;
+			uint32_t shifted = ((old >> 18) ^ old) >> 27;
+			uint32_t rot = old >> 59;
+			return (shifted >> rot) | (shifted << ((-rot) & 31));
+		}
+		//A number from 0 up to but not including range
+		uint32_t below(uint32_t range) { return (uint64_t) next() * range >> 32; }
+};
+
+AccKey generatedKey(size_t);
+void generateAccounts(AccountTable*, size_t, uint64_t);
+bool generateTransactions(const char*, const AccountTable*, size_t, uint64_t);
+
+#endif
@@ -0,0 +1,175 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              index.cpp
+	DESCRIPTION:       The account number index. Finds an account by number in constant time,
+	                   instead of searching through every account
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include "index.h"
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::home()
+DESCRIPTION:       Works out which slot a key should be in, if nothing else is there
+RETURNS:           The slot number
+----------------------------------------------------------------------------- */
+size_t AccountIndex::home(AccKey key) const {
+	//Fibonacci hashing - the multiply spreads neighbouring keys across the high bits
+	return (key * 0x9E3779B97F4A7C15ull) >> 32 & (slots.size() - 1);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::add()
+DESCRIPTION:       Puts a key into the table, unless it's already there
+RETURNS:           true if it was put in, false if the key was already there
+NOTES:             When the same number is in the database more than once, the first one added wins
+----------------------------------------------------------------------------- */
+bool AccountIndex::add(AccKey key, uint32_t row) {
+	if((count + 1) * 2 > slots.size()) grow();
+	size_t i = home(key);
+	while(slots[i].key != ACC_KEY_INVALID) {
+		if(slots[i].key == key) return false;
+		i = (i + 1) & (slots.size() - 1);
+	}
+	slots[i].key = key;
+	slots[i].row = row;
+	count++;
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::remove()
+DESCRIPTION:       Empties slot i, then moves any keys which were pushed past their home slot back,
+                   so that lookups don't stop short at the gap
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountIndex::remove(size_t i) {
+	slots[i].key = ACC_KEY_INVALID;
+	count--;
+	size_t gap = i, mask = slots.size() - 1;
+	for(size_t j = (i + 1) & mask; slots[j].key != ACC_KEY_INVALID; j = (j + 1) & mask) {
+		size_t want = home(slots[j].key);
+		//Move it if its home slot isn't between the gap and where it is now
+		if(((j - want) & mask) >= ((j - gap) & mask)) {
+			slots[gap] = slots[j];
+			slots[j].key = ACC_KEY_INVALID;
+			gap = j;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::grow()
+DESCRIPTION:       Doubles the size of the table
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountIndex::grow() {
+	Slot empty = {ACC_KEY_INVALID, 0};
+	vector<Slot> old(slots.size() ? slots.size() * 2 : 16, empty);
+	old.swap(slots);
+	count = 0;
+	for(Slot& slot : old) {
+		if(slot.key != ACC_KEY_INVALID) add(slot.key, slot.row);
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::build()
+DESCRIPTION:       Fills the index from scratch with every account in people
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountIndex::build(const AccountTable* people) {
+	size_t size = 16;
+	while(size < people->size() * 2 + 2) size *= 2;
+	Slot empty = {ACC_KEY_INVALID, 0};
+	slots.assign(size, empty);
+	count = 0;
+	duplicates = 0;
+	for(unsigned int row = 0; row < people->size(); row++) {
+		if(!add(people->key(row), row)) duplicates++;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::find()
+DESCRIPTION:       Looks up an account number
+RETURNS:           The account's position in the database, or -1 if there's no such account
+----------------------------------------------------------------------------- */
+int AccountIndex::find(AccKey key) const {
+	if(!slots.size() || key == ACC_KEY_INVALID) return -1;
+	for(size_t i = home(key); slots[i].key != ACC_KEY_INVALID; i = (i + 1) & (slots.size() - 1)) {
+		if(slots[i].key == key) return slots[i].row;
+	}
+	return -1;
+}
+
+int AccountIndex::find(const char* number) const {
+	if(strlen(number) != ACC_NUM_LENGTH) return -1;
+	return find(packAccNum(number));
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::appended()
+DESCRIPTION:       Updates the index after an account has been added to the end of people, at row
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void AccountIndex::appended(const AccountTable* people, unsigned int row) {
+	if(!add(people->key(row), row)) duplicates++;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::moved()
+DESCRIPTION:       Updates the index after the account with the given key was erased from row of people,
+                   and the account which was at row from was moved into its place
+RETURNS:           Void function
+NOTES:             Constant time, unless the account that's indexed for a number that's in the database
+                   more than once is the one that was erased
+----------------------------------------------------------------------------- */
+void AccountIndex::moved(const AccountTable* people, unsigned int row, AccKey key, unsigned int from) {
+	size_t i = home(key);
+	while(slots[i].key != ACC_KEY_INVALID && slots[i].key != key) i = (i + 1) & (slots.size() - 1);
+	if(slots[i].key == key && slots[i].row == row) {
+		remove(i);
+		//Another account with the same number has to take over. Finding it means looking through them all
+		if(duplicates) {
+			for(unsigned int r = 0; r < people->size(); r++) {
+				if(people->key(r) == key) {
+					add(key, r == row ? from : r);
+					duplicates--;
+					break;
+				}
+			}
+		}
+	} else if(slots[i].key == key && duplicates) {
+		//It was one of the duplicates the index had left out, so there's one fewer
+		duplicates--;
+	}
+	if(from == row) return;
+
+	AccKey movedKey = people->key(row);
+	for(i = home(movedKey); slots[i].key != ACC_KEY_INVALID; i = (i + 1) & (slots.size() - 1)) {
+		if(slots[i].key == movedKey) {
+			if(slots[i].row == from) slots[i].row = row;
+			break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          AccountIndex::restore()
+DESCRIPTION:       Puts back a table of size slots saved from table(), holding count accounts,
+                   duplicates of which were left out
+RETURNS:           true if it could be, false if the table can't be right
+NOTES:             Nothing is hashed again, so it has to have been saved for the same rows
+----------------------------------------------------------------------------- */
+bool AccountIndex::restore(const Slot* table, size_t size, size_t count, size_t duplicates) {
+	if(size < 16 || size & (size - 1) || count * 2 > size) return false;
+	slots.assign(table, table + size);
+	this->count = count;
+	this->duplicates = duplicates;
+	return true;
+}
@@ -0,0 +1,55 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              index.h
+
+DESCRIPTION:       A hash index from account number to the account's position in the database
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __INDEX_H__
+#define __INDEX_H__
+
+#include <vector>
+#include <stdint.h>
+#include "account.h"
+#include "accounttable.h"
+
+using namespace std;
+
+//Open addressing with linear probing. The table is kept at most half full
+class AccountIndex {
+	public:
+		struct Slot {
+			//ACC_KEY_INVALID means the slot is empty
+			AccKey key;
+			uint32_t row;
+		};
+	private:
+		vector<Slot> slots;
+		size_t count;
+		//Accounts whose number was already in the index when they were added
+		size_t duplicates;
+
+		size_t home(AccKey) const;
+		bool add(AccKey, uint32_t);
+		void remove(size_t);
+		void grow();
+	public:
+		AccountIndex() : count(0), duplicates(0) {}
+
+		void build(const AccountTable*);
+		int find(AccKey) const;
+		int find(const char*) const;
+		void appended(const AccountTable*, unsigned int);
+		void moved(const AccountTable*, unsigned int, AccKey, unsigned int);
+
+		//The whole table, for saving it in an index file, and putting it back from one
+		const vector<Slot>& table() const { return slots; }
+		size_t size() const { return count; }
+		size_t duplicateCount() const { return duplicates; }
+		bool restore(const Slot*, size_t, size_t, size_t);
+};
+
+#endif
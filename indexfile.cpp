@@ -0,0 +1,236 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              indexfile.cpp
+	DESCRIPTION:       Writing and reading the index file that goes with a database file.
+	                   The index and orders go in and out as they are in memory - nothing is sorted or hashed
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stddef.h>
+#include "indexfile.h"
+
+using namespace std;
+
+//Fletcher's checksum, 32 bits at a time. The file is a whole number of 32 bit words,
+//but it's written in pieces that aren't, so a word can be split between two of them
+class IndexChecksum {
+	private:
+		uint64_t low, high;
+		char partial[sizeof(uint32_t)];
+		size_t held;
+
+		void word(const char* bytes) {
+			uint32_t value;
+			memcpy(&value, bytes, sizeof(value));
+			low += value;
+			high += low;
+		}
+	public:
+		IndexChecksum() : low(0), high(0), held(0) {}
+
+		void add(const void* data, size_t length) {
+			const char* bytes = (const char*) data;
+			for(; held && length; length--) {
+				partial[held++] = *bytes++;
+				if(held == sizeof(partial)) {
+					word(partial);
+					held = 0;
+				}
+			}
+			size_t i = 0;
+			for(; i + sizeof(uint32_t) <= length; i += sizeof(uint32_t)) word(bytes + i);
+			for(; i < length; i++) partial[held++] = bytes[i];
+		}
+		uint64_t value() const { return low ^ (high << 32 | high >> 32); }
+};
+
+//Bytes length bytes take up once they're padded out to 8
+static size_t padded(uint64_t length) {
+	return (length + sizeof(uint64_t) - 1) / sizeof(uint64_t) * sizeof(uint64_t);
+}
+
+//Where each part of an index file starts, and where the file ends, worked out from its header
+struct IndexFileLayout {
+	size_t slots, names, nameTable, index, orders, nameText, end;
+};
+
+static IndexFileLayout layout(const IndexFileHeader& header) {
+	IndexFileLayout at;
+	bool slotted = header.flags & INDEX_FILE_SLOTS;
+	at.slots = sizeof(header);
+	at.names = at.slots + (slotted ? padded(header.rows * sizeof(uint32_t)) : 0);
+	at.nameTable = at.names + (slotted ? header.rows * 2 * sizeof(NameRef) : 0);
+	at.index = at.nameTable + padded(header.nameSlots * sizeof(NameRef));
+	at.orders = at.index + header.indexSlots * sizeof(AccountIndex::Slot);
+	at.nameText = at.orders + __builtin_popcount(header.orders) * header.rows * sizeof(uint32_t);
+	at.end = at.nameText + padded(header.nameBytes);
+	return at;
+}
+
+//Whether the order for column goes in the index file. The balance order changes with every transaction,
+//so it would never be any good for long
+static bool keepOrder(const OrderIndex* orders, int column, size_t rows) {
+	return column != ORDER_BALANCE && orders[column].isBuilt() && orders[column].size() == rows;
+}
+
+//Hands everything that goes after the header to visit, a piece at a time, in the order it goes in the file
+template<class Visit> static void visitIndexFile(const IndexFileHeader& header, const vector<uint32_t>* slots,
+                                                 const vector<NameRef>& names, const NameArena& arena,
+                                                 const AccountIndex& index, const OrderIndex* orders, Visit visit) {
+	static const char zeroes[sizeof(uint64_t)] = {};
+	auto piece = [&](const void* data, size_t length) {
+		visit(data, length);
+		visit(zeroes, padded(length) - length);
+	};
+	if(slots) {
+		piece(slots->data(), header.rows * sizeof(uint32_t));
+		piece(names.data(), names.size() * sizeof(NameRef));
+		piece(arena.table().data(), header.nameSlots * sizeof(NameRef));
+	}
+	piece(index.table().data(), index.table().size() * sizeof(AccountIndex::Slot));
+	for(int column = 0; column < ORDER_COUNT; column++) {
+		if(!(header.orders & 1u << column)) continue;
+		for(const vector<uint32_t>& block : orders[column].rowBlocks()) visit(block.data(), block.size() * sizeof(uint32_t));
+	}
+	if(slots) piece(arena.block().data(), header.nameBytes);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          writeIndexFile()
+DESCRIPTION:       Writes the index file for the database file dbName, which has just been saved with the accounts
+                   in people. index and every order that's been built apart from the balance order go in it.
+                   For a binary database, so does slots, the slot of every row, and the names of every row
+RETURNS:           true if it was written, false otherwise
+NOTES:             slots is null for a text database, which saving leaves in number order. orders has ORDER_COUNT
+                   entries. The accounts have to be in number order, as saving leaves them
+----------------------------------------------------------------------------- */
+bool writeIndexFile(const char* dbName, const AccountTable& people, const vector<uint32_t>* slots,
+                    const AccountIndex& index, const OrderIndex* orders) {
+	IndexFileHeader header = IndexFileHeader();
+	memcpy(header.magic, INDEX_FILE_MAGIC, INDEX_FILE_MAGIC_LENGTH);
+	header.version = INDEX_FILE_VERSION;
+	header.flags = slots ? INDEX_FILE_SLOTS : INDEX_FILE_SORTED;
+	if(!getDatabaseBase(dbName, &header.base)) return false;
+	header.rows = people.size();
+	header.indexSlots = index.table().size();
+	header.indexCount = index.size();
+	header.indexDuplicates = index.duplicateCount();
+	for(int column = 0; column < ORDER_COUNT; column++) {
+		if(keepOrder(orders, column, people.size())) header.orders |= 1u << column;
+	}
+	const NameArena& arena = people.nameArena();
+	vector<NameRef> names;
+	if(slots) {
+		header.nameBytes = arena.block().size();
+		header.nameSlots = arena.table().size();
+		header.nameCount = arena.size();
+		names.reserve(people.size() * 2);
+		for(size_t row = 0; row < people.size(); row++) {
+			names.push_back(people.detail(row).first);
+			names.push_back(people.detail(row).last);
+		}
+	}
+
+	IndexChecksum sum;
+	visitIndexFile(header, slots, names, arena, index, orders, [&](const void* data, size_t length) { sum.add(data, length); });
+	header.checksum = sum.value();
+
+	FileWriter out;
+	if(!out.open((string(dbName) + INDEX_FILE_SUFFIX).c_str())) return false;
+	out.write(&header, sizeof(header));
+	visitIndexFile(header, slots, names, arena, index, orders, [&](const void* data, size_t length) { out.write(data, length); });
+	return out.commit();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          restampIndexFile()
+DESCRIPTION:       Marks the index file as going with the database file dbName as it is now.
+                   For when the database file has been saved, but nothing in the index file has changed
+RETURNS:           true if it was marked, false otherwise
+NOTES:             Isn't synced. If the new header is lost, the index file is just built again next time
+----------------------------------------------------------------------------- */
+bool restampIndexFile(const char* dbName) {
+	JournalBase base;
+	if(!getDatabaseBase(dbName, &base)) return false;
+	int fd = open((string(dbName) + INDEX_FILE_SUFFIX).c_str(), O_RDWR);
+	if(fd < 0) return false;
+	IndexFileHeader header;
+	bool stamped = pread(fd, &header, sizeof(header), 0) == sizeof(header)
+		&& !memcmp(header.magic, INDEX_FILE_MAGIC, INDEX_FILE_MAGIC_LENGTH) && header.version == INDEX_FILE_VERSION
+		&& pwrite(fd, &base, sizeof(base), offsetof(IndexFileHeader, base)) == sizeof(base);
+	close(fd);
+	return stamped;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedIndexFile::open()
+DESCRIPTION:       Maps the index file for the database file dbName, and checks that it goes with it as it is now
+RETURNS:           true if it does, false if there isn't one, or it's damaged or out of date
+----------------------------------------------------------------------------- */
+bool MappedIndexFile::open(const char* dbName) {
+	close();
+	JournalBase base;
+	if(!getDatabaseBase(dbName, &base)) return false;
+	if(!file.open((string(dbName) + INDEX_FILE_SUFFIX).c_str()) || file.size() < sizeof(IndexFileHeader)) {
+		close();
+		return false;
+	}
+	memcpy(&header, file.data(), sizeof(header));
+	//Nothing in it can be bigger than the file, which keeps working out the layout from overflowing
+	if(memcmp(header.magic, INDEX_FILE_MAGIC, INDEX_FILE_MAGIC_LENGTH) || header.version != INDEX_FILE_VERSION
+		|| memcmp(&header.base, &base, sizeof(base)) || header.rows > file.size() || header.indexSlots > file.size()
+		|| header.nameBytes > file.size() || header.nameSlots > file.size() || layout(header).end != file.size()) {
+		close();
+		return false;
+	}
+	IndexChecksum sum;
+	sum.add(file.data() + sizeof(header), file.size() - sizeof(header));
+	if(sum.value() != header.checksum) {
+		close();
+		return false;
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedIndexFile::prepare()
+DESCRIPTION:       Gets reader, which has the binary database file open, ready to read it into people
+                   in number order, with the names the index file has for it
+RETURNS:           true if it is, false if the index file doesn't have the slots
+NOTES:             people has to be empty, since its NameArena is replaced. If the slots turn out not
+                   to fit the database file, reading fails, and people should be cleared
+----------------------------------------------------------------------------- */
+bool MappedIndexFile::prepare(AccountTable* people, DatabaseReader* reader) const {
+	if(!file.data() || !(header.flags & INDEX_FILE_SLOTS)) return false;
+	IndexFileLayout at = layout(header);
+	if(!people->nameArena().restore(file.data() + at.nameText, header.nameBytes,
+		(const NameRef*) (file.data() + at.nameTable), header.nameSlots, header.nameCount)) return false;
+	reader->setOrder((const uint32_t*) (file.data() + at.slots), (const NameRef*) (file.data() + at.names), header.rows);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          MappedIndexFile::restore()
+DESCRIPTION:       Puts the index and every order in the file back
+RETURNS:           true if they were, false otherwise
+NOTES:             orders has ORDER_COUNT entries. Orders that weren't in the file are left as they were.
+                   If it fails, anything may have been put in index and orders, so they should be built again
+----------------------------------------------------------------------------- */
+bool MappedIndexFile::restore(AccountIndex* index, OrderIndex* orders) const {
+	if(!file.data()) return false;
+	IndexFileLayout at = layout(header);
+	if(!index->restore((const AccountIndex::Slot*) (file.data() + at.index), header.indexSlots, header.indexCount,
+		header.indexDuplicates)) return false;
+	const char* pos = file.data() + at.orders;
+	for(int column = 0; column < ORDER_COUNT; column++) {
+		if(!(header.orders & 1u << column)) continue;
+		orders[column].restore((OrderColumn) column, (const uint32_t*) pos, header.rows);
+		pos += header.rows * sizeof(uint32_t);
+	}
+	return true;
+}
@@ -0,0 +1,80 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              indexfile.h
+
+DESCRIPTION:       The index file kept next to a database file, with the account number index and orders
+                   already built, so loading the database doesn't have to build them again
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __INDEXFILE_H__
+#define __INDEXFILE_H__
+
+#include <vector>
+#include <stdint.h>
+#include "accounttable.h"
+#include "database.h"
+#include "journal.h"
+#include "index.h"
+#include "orderindex.h"
+
+//The index file for a database file is the database's file name with this added to the end
+#define INDEX_FILE_SUFFIX ".index"
+#define INDEX_FILE_MAGIC "BANKINDX"
+#define INDEX_FILE_MAGIC_LENGTH 8
+#define INDEX_FILE_VERSION 1
+
+//Flags. Either way, loading the database file doesn't have to sort it
+//A text database file, with the accounts in number order
+#define INDEX_FILE_SORTED 1
+//A binary database file. The index file has the slot of every row and the names it had,
+//so the accounts can be read straight into number order without interning any names
+#define INDEX_FILE_SLOTS 2
+
+//An IndexFileHeader is followed by, if there's INDEX_FILE_SLOTS, the slot of every row, the first and last
+//NameRef of every row, and the NameArena's table. Then the AccountIndex's table, the rows of each order in
+//orders in column order, and last of all the NameArena's names if there's INDEX_FILE_SLOTS.
+//Everything apart from the orders is padded out to 8 bytes. Every row number is a row of the database once it's loaded and in number order
+struct IndexFileHeader {
+	char magic[INDEX_FILE_MAGIC_LENGTH];
+	uint32_t version;
+	uint32_t flags;
+	//The database file it goes with. If that's changed since, the index file is no good
+	JournalBase base;
+	uint64_t rows;
+	uint64_t indexSlots;
+	uint64_t indexCount;
+	uint64_t indexDuplicates;
+	uint64_t nameBytes;
+	uint64_t nameSlots;
+	uint64_t nameCount;
+	//One bit for each OrderColumn that's in the file
+	uint32_t orders;
+	uint32_t reserved;
+	//Of everything after the header. Only needs to catch a file that was cut short or damaged, not attacks
+	uint64_t checksum;
+};
+
+//A read-only mapping of the index file for a database file, which has been checked to go with it
+class MappedIndexFile {
+	private:
+		MappedFile file;
+		IndexFileHeader header;
+	public:
+		MappedIndexFile() : header() {}
+
+		bool open(const char*);
+		void close() { file.close(); }
+
+		uint64_t rows() const { return header.rows; }
+		uint32_t flags() const { return header.flags; }
+		bool prepare(AccountTable*, DatabaseReader*) const;
+		bool restore(AccountIndex*, OrderIndex*) const;
+};
+
+bool writeIndexFile(const char*, const AccountTable&, const vector<uint32_t>*, const AccountIndex&, const OrderIndex*);
+bool restampIndexFile(const char*);
+
+#endif
@@ -0,0 +1,528 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              journal.cpp
+	DESCRIPTION:       The mutation journal. Every deposit, withdrawal, transfer, new account and closed account
+	                   is appended to the journal and synced to disk, either as it happens or grouped with others
+	                   (see JournalSync). When the database is loaded, the journal is replayed on top of it,
+	                   so nothing is lost if the program dies before it gets a chance to save the database file
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "journal.h"
+#include "database.h"
+
+using namespace std;
+
+//The most data any one entry carries
+#define JOURNAL_MAX_ENTRY sizeof(Account)
+
+//FNV-1a. Only needs to catch torn writes, not attacks
+static uint32_t checksum(uint32_t op, const char* data, uint32_t length) {
+	uint32_t hash = 2166136261u ^ op;
+	hash *= 16777619u;
+	for(uint32_t i = 0; i < length; i++) {
+		hash ^= (unsigned char) data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          getDatabaseBase()
+DESCRIPTION:       Fills in base with the identity of the database file dbName as it is now
+RETURNS:           true if the file is there, false otherwise
+NOTES:             Anything else kept next to a database file can use it to tell whether it's still current
+----------------------------------------------------------------------------- */
+bool getDatabaseBase(const char* dbName, JournalBase* base) {
+	struct stat info;
+	if(stat(dbName, &info)) return false;
+	*base = JournalBase();
+	base->inode = info.st_ino;
+	if(readDatabaseGeneration(dbName, &base->generation)) return true;
+	base->size = info.st_size;
+	base->mtimeSec = info.st_mtim.tv_sec;
+	base->mtimeNsec = info.st_mtim.tv_nsec;
+	return true;
+}
+
+//Helpers for packing entries. Each copies a field and moves pos past it
+static void put(char** pos, const void* field, size_t length) {
+	memcpy(*pos, field, length);
+	*pos += length;
+}
+
+static void get(const char** pos, void* field, size_t length) {
+	memcpy(field, *pos, length);
+	*pos += length;
+}
+
+Journal::Journal() : fd(-1), policy(JOURNAL_SYNC_EACH), groupBytes(JOURNAL_GROUP_BYTES), groupMs(JOURNAL_GROUP_MS),
+	logged(0), durable(0), loggedBytes(0), flushing(false), stopping(false), failed(false), counters() {}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::setPolicy()
+DESCRIPTION:       Chooses when logged changes are synced to disk. Grouped and asynchronous syncs happen
+                   once bytes bytes are waiting, or ms milliseconds after the first waiting change was logged
+RETURNS:           Void function
+NOTES:             Must be called before open()
+----------------------------------------------------------------------------- */
+void Journal::setPolicy(JournalSync sync, size_t bytes, unsigned int ms) {
+	policy = sync;
+	groupBytes = bytes;
+	groupMs = ms;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::open()
+DESCRIPTION:       Opens the journal belonging to the database file dbName, creating it if needed.
+                   If the journal was started on top of the database file as it is now,
+                   the changes in it are replayed onto people
+RETURNS:           true if the journal is ready to be logged to, false otherwise
+NOTES:             people must already be sorted by account number.
+                   If something goes wrong, the reason is written into error (JOURNAL_ERROR_LENGTH characters)
+----------------------------------------------------------------------------- */
+bool Journal::open(const char* dbName, AccountTable* people, char* error) {
+	close();
+	fileName = string(dbName) + JOURNAL_SUFFIX;
+
+	JournalBase base;
+	if(!getDatabaseBase(dbName, &base)) {
+		snprintf(error, JOURNAL_ERROR_LENGTH, "could not read \"%s\"", dbName);
+		return false;
+	}
+
+	//A checkpoint which put its database file in place but died before it could do the same with
+	//its journal left that journal behind. If it's for the database file as it is now, it's the journal
+	string nextName = fileName + JOURNAL_NEXT_SUFFIX;
+	JournalHeader next;
+	int nextFd = ::open(nextName.c_str(), O_RDONLY);
+	if(nextFd >= 0) {
+		bool current = pread(nextFd, &next, sizeof(next), 0) == sizeof(next)
+			&& !memcmp(next.magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH) && next.version == JOURNAL_VERSION
+			&& !memcmp(&next.base, &base, sizeof(base));
+		::close(nextFd);
+		if(!current || rename(nextName.c_str(), fileName.c_str())) unlink(nextName.c_str());
+	}
+
+	fd = ::open(fileName.c_str(), O_RDWR | O_CREAT, 0644);
+	if(fd < 0) {
+		snprintf(error, JOURNAL_ERROR_LENGTH, "could not open \"%s\"", fileName.c_str());
+		return false;
+	}
+
+	MappedFile file;
+	if(!file.open(fileName.c_str())) {
+		snprintf(error, JOURNAL_ERROR_LENGTH, "could not read \"%s\"", fileName.c_str());
+		close();
+		return false;
+	}
+	const JournalHeader* header = (const JournalHeader*) file.data();
+	if(file.size() < sizeof(JournalHeader) || memcmp(header->magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH)
+		|| header->version != JOURNAL_VERSION || memcmp(&header->base, &base, sizeof(base))) {
+		//Either a brand new journal, or one from before the database was last saved - start over
+		file.close();
+		if(!reset(dbName)) {
+			snprintf(error, JOURNAL_ERROR_LENGTH, "could not write \"%s\"", fileName.c_str());
+			close();
+			return false;
+		}
+		if(policy != JOURNAL_SYNC_EACH) flusher = thread(&Journal::flushLoop, this);
+		return true;
+	}
+
+	if(!replay(file.data(), file.size(), people)) {
+		snprintf(error, JOURNAL_ERROR_LENGTH, "could not repair \"%s\"", fileName.c_str());
+		close();
+		return false;
+	}
+	if(policy != JOURNAL_SYNC_EACH) flusher = thread(&Journal::flushLoop, this);
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::replay()
+DESCRIPTION:       Applies every complete entry in the journal to people, then cuts off anything after them
+RETURNS:           true if the journal is ready to be appended to, false otherwise
+NOTES:             An entry that was only partly written when the program died is the end of the journal
+----------------------------------------------------------------------------- */
+bool Journal::replay(const char* data, size_t length, AccountTable* people) {
+	size_t pos = sizeof(JournalHeader);
+	while(pos + sizeof(JournalEntryHeader) <= length) {
+		JournalEntryHeader entry;
+		memcpy(&entry, data + pos, sizeof(entry));
+		const char* field = data + pos + sizeof(entry);
+		if(entry.length > JOURNAL_MAX_ENTRY || pos + sizeof(entry) + entry.length > length
+			|| entry.checksum != checksum(entry.op, field, entry.length)) break;
+
+		AccKey key, other;
+		Cents amount, balance, otherBalance;
+		int row;
+		switch(entry.op) {
+			case JOURNAL_DEPOSIT:
+			case JOURNAL_WITHDRAW:
+				get(&field, &key, sizeof(key));
+				get(&field, &amount, sizeof(amount));
+				get(&field, &balance, sizeof(balance));
+				row = people->find(key);
+				if(row >= 0) people->balance(row) = balance;
+				break;
+			case JOURNAL_TRANSFER:
+				get(&field, &key, sizeof(key));
+				get(&field, &other, sizeof(other));
+				get(&field, &amount, sizeof(amount));
+				get(&field, &balance, sizeof(balance));
+				get(&field, &otherBalance, sizeof(otherBalance));
+				row = people->find(key);
+				if(row >= 0) people->balance(row) = balance;
+				row = people->find(other);
+				if(row >= 0) people->balance(row) = otherBalance;
+				break;
+			case JOURNAL_OPEN: {
+				Account person;
+				get(&field, &person, sizeof(person));
+				if(people->find(person.key) < 0) people->insert(people->lowerBound(person.key), person);
+				break;
+			}
+			case JOURNAL_CLOSE:
+				get(&field, &key, sizeof(key));
+				row = people->find(key);
+				if(row >= 0) people->erase(row);
+				break;
+		}
+		pos += sizeof(entry) + entry.length;
+	}
+
+	//Throw away whatever was after the last good entry so new entries don't get stuck behind it
+	if(pos != length && (ftruncate(fd, pos) || fdatasync(fd))) return false;
+	loggedBytes = pos - sizeof(JournalHeader);
+	return lseek(fd, pos, SEEK_SET) == (off_t) pos;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::reset()
+DESCRIPTION:       Empties the journal, including any changes still waiting to be flushed.
+                   Called once the database file dbName has been saved with all of the changes in the journal
+RETURNS:           true if the journal was emptied, false otherwise
+----------------------------------------------------------------------------- */
+bool Journal::reset(const char* dbName) {
+	unique_lock<mutex> guard(lock);
+	if(fd < 0) return false;
+	//Anything still waiting is in the database file now, but a flush which is under way
+	//has to finish before the file can be cut short
+	flushed.wait(guard, [this]() { return !flushing; });
+	buffer.clear();
+	durable = logged;
+	loggedBytes = 0;
+	flushed.notify_all();
+
+	JournalHeader header = JournalHeader();
+	memcpy(header.magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH);
+	header.version = JOURNAL_VERSION;
+	if(!getDatabaseBase(dbName, &header.base)) return false;
+
+	if(ftruncate(fd, 0) || pwrite(fd, &header, sizeof(header), 0) != sizeof(header) || fdatasync(fd))
+		return false;
+	return lseek(fd, sizeof(header), SEEK_SET) == sizeof(header);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::mark()
+DESCRIPTION:       Marks how far the journal has got, for rebase()
+RETURNS:           The mark. 0 means nothing's been logged since the journal was started
+----------------------------------------------------------------------------- */
+uint64_t Journal::mark() const {
+	lock_guard<mutex> guard(lock);
+	return loggedBytes;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::rebase()
+DESCRIPTION:       Moves the journal on top of a new database file, snapshotName, which has every change
+                   that was logged before mark in it. snapshotName is renamed to dbName, and the journal
+                   is started again with just the changes logged since mark
+RETURNS:           true if it was moved, false otherwise
+NOTES:             If it wasn't, the database file and journal are left as they were, unless the database
+                   file was put in place and the journal couldn't be. Then nothing more can be logged.
+                   Changes logged since mark might already be in snapshotName. Replaying them sets the same
+                   balances again, so that doesn't matter
+----------------------------------------------------------------------------- */
+bool Journal::rebase(const char* dbName, const char* snapshotName, uint64_t mark) {
+	unique_lock<mutex> guard(lock);
+	if(fd < 0 || failed || mark > loggedBytes) return false;
+	//Everything has to be in the file to be copied out of it
+	flushed.wait(guard, [this]() { return !flushing; });
+	if(!buffer.empty()) {
+		if(!write(buffer.data(), buffer.size())) {
+			failed = true;
+			flushed.notify_all();
+			return false;
+		}
+		counters.bytes += buffer.size();
+		counters.flushes++;
+		buffer.clear();
+		durable = logged;
+		flushed.notify_all();
+	}
+
+	JournalHeader header = JournalHeader();
+	memcpy(header.magic, JOURNAL_MAGIC, JOURNAL_MAGIC_LENGTH);
+	header.version = JOURNAL_VERSION;
+	if(!getDatabaseBase(snapshotName, &header.base)) return false;
+	vector<char> kept(sizeof(header) + loggedBytes - mark);
+	memcpy(kept.data(), &header, sizeof(header));
+	size_t copied = sizeof(header);
+	while(copied < kept.size()) {
+		ssize_t result = pread(fd, kept.data() + copied, kept.size() - copied, mark + copied);
+		if(result <= 0) return false;
+		copied += result;
+	}
+
+	string nextName = fileName + JOURNAL_NEXT_SUFFIX;
+	int next = ::open(nextName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if(next < 0) return false;
+	size_t written = 0;
+	while(written < kept.size()) {
+		ssize_t result = ::write(next, kept.data() + written, kept.size() - written);
+		if(result < 0) break;
+		written += result;
+	}
+	if(written < kept.size() || fdatasync(next) || rename(snapshotName, dbName)) {
+		::close(next);
+		unlink(nextName.c_str());
+		return false;
+	}
+	//If the program dies here, open() finds the new journal and finishes the job
+	if(rename(nextName.c_str(), fileName.c_str())) {
+		::close(next);
+		failed = true;
+		return false;
+	}
+	//Make sure both renames are on disk before the old journal's changes are let go of
+	size_t slash = fileName.rfind('/');
+	string directory = slash == string::npos ? "." : slash ? fileName.substr(0, slash) : "/";
+	int dir = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+	if(dir >= 0) {
+		fsync(dir);
+		::close(dir);
+	}
+
+	::close(fd);
+	fd = next;
+	loggedBytes -= mark;
+	return lseek(fd, 0, SEEK_END) == (off_t) kept.size();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::close()
+DESCRIPTION:       Flushes anything that's waiting and closes the journal file
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void Journal::close() {
+	stopFlusher();
+	if(fd >= 0) ::close(fd);
+	fd = -1;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::stopFlusher()
+DESCRIPTION:       Has the flusher thread write out what's waiting and then stop
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void Journal::stopFlusher() {
+	if(!flusher.joinable()) return;
+	{
+		lock_guard<mutex> guard(lock);
+		stopping = true;
+	}
+	wake.notify_one();
+	flusher.join();
+	stopping = false;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::flushLoop()
+DESCRIPTION:       The flusher thread. Waits for changes to be logged, gives others the chance to join them,
+                   then writes and syncs them all at once
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void Journal::flushLoop() {
+	vector<char> pending;
+	unique_lock<mutex> guard(lock);
+	while(true) {
+		wake.wait(guard, [this]() { return stopping || !buffer.empty(); });
+		if(buffer.empty()) return;
+		if(!stopping && groupMs) {
+			wake.wait_until(guard, bufferStart + chrono::milliseconds(groupMs), [this]() {
+				return stopping || buffer.size() >= groupBytes;
+			});
+		}
+
+		pending.swap(buffer);
+		uint64_t last = logged;
+		flushing = true;
+		guard.unlock();
+
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		bool ok = write(pending.data(), pending.size());
+		uint64_t nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+
+		guard.lock();
+		flushing = false;
+		if(ok) {
+			durable = last;
+			counters.bytes += pending.size();
+			counters.flushes++;
+			counters.flushNanos += nanos;
+			if(nanos > counters.maxFlushNanos) counters.maxFlushNanos = nanos;
+		} else failed = true;
+		pending.clear();
+		flushed.notify_all();
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::append()
+DESCRIPTION:       Logs an entry, syncing it to disk as the policy says
+RETURNS:           true if the entry was logged, false otherwise
+NOTES:             With JOURNAL_SYNC_ASYNC, a failure to write the entry is only reported by later calls
+----------------------------------------------------------------------------- */
+bool Journal::append(JournalOp op, const char* data, uint32_t length) {
+	char buf[sizeof(JournalEntryHeader) + JOURNAL_MAX_ENTRY];
+	JournalEntryHeader entry;
+	entry.length = length;
+	entry.checksum = checksum(op, data, length);
+	entry.op = op;
+	memcpy(buf, &entry, sizeof(entry));
+	memcpy(buf + sizeof(entry), data, length);
+	size_t total = sizeof(entry) + length;
+
+	unique_lock<mutex> guard(lock);
+	if(fd < 0 || failed) return false;
+	counters.entries++;
+	loggedBytes += total;
+
+	if(policy == JOURNAL_SYNC_EACH) {
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		if(!write(buf, total)) {
+			failed = true;
+			return false;
+		}
+		uint64_t nanos = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+		counters.bytes += total;
+		counters.flushes++;
+		counters.flushNanos += nanos;
+		if(nanos > counters.maxFlushNanos) counters.maxFlushNanos = nanos;
+		return true;
+	}
+
+	bool first = buffer.empty();
+	if(first) bufferStart = chrono::steady_clock::now();
+	buffer.insert(buffer.end(), buf, buf + total);
+	uint64_t number = ++logged;
+	//The flusher only needs waking to start its timer, or to cut it short
+	if(first || policy == JOURNAL_SYNC_GROUP || buffer.size() >= groupBytes) wake.notify_one();
+	if(policy == JOURNAL_SYNC_ASYNC) return true;
+
+	flushed.wait(guard, [this, number]() { return durable >= number || failed; });
+	return durable >= number;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::write()
+DESCRIPTION:       Writes entries to the end of the journal file and waits for them to reach the disk
+RETURNS:           true if the entries are safely on disk, false otherwise
+----------------------------------------------------------------------------- */
+bool Journal::write(const char* data, size_t length) {
+	size_t written = 0;
+	while(written < length) {
+		ssize_t result = ::write(fd, data + written, length - written);
+		if(result < 0) return false;
+		written += result;
+	}
+	return !fdatasync(fd);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::logDeposit(), logWithdraw(), logTransfer(), logOpen(), logClose()
+DESCRIPTION:       Log a change. Call these after the change has been made to the account(s),
+                   with the balances they ended up with
+RETURNS:           true if the change was logged, false otherwise
+NOTES:             Whether the change is on disk yet when these return depends on the sync policy
+----------------------------------------------------------------------------- */
+bool Journal::logDeposit(AccKey key, Cents amount, Cents balance) {
+	char data[JOURNAL_MAX_ENTRY], *pos = data;
+	put(&pos, &key, sizeof(key));
+	put(&pos, &amount, sizeof(amount));
+	put(&pos, &balance, sizeof(balance));
+	return append(JOURNAL_DEPOSIT, data, pos - data);
+}
+
+bool Journal::logWithdraw(AccKey key, Cents amount, Cents balance) {
+	char data[JOURNAL_MAX_ENTRY], *pos = data;
+	put(&pos, &key, sizeof(key));
+	put(&pos, &amount, sizeof(amount));
+	put(&pos, &balance, sizeof(balance));
+	return append(JOURNAL_WITHDRAW, data, pos - data);
+}
+
+bool Journal::logTransfer(AccKey from, AccKey to, Cents amount, Cents fromBalance, Cents toBalance) {
+	char data[JOURNAL_MAX_ENTRY], *pos = data;
+	put(&pos, &from, sizeof(from));
+	put(&pos, &to, sizeof(to));
+	put(&pos, &amount, sizeof(amount));
+	put(&pos, &fromBalance, sizeof(fromBalance));
+	put(&pos, &toBalance, sizeof(toBalance));
+	return append(JOURNAL_TRANSFER, data, pos - data);
+}
+
+bool Journal::logOpen(const Account& acc) {
+	return append(JOURNAL_OPEN, (const char*) &acc, sizeof(acc));
+}
+
+bool Journal::logClose(AccKey key) {
+	return append(JOURNAL_CLOSE, (const char*) &key, sizeof(key));
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::stats()
+DESCRIPTION:       Gets the journal's counters
+RETURNS:           A copy of the counters
+----------------------------------------------------------------------------- */
+JournalStats Journal::stats() const {
+	lock_guard<mutex> guard(lock);
+	return counters;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          Journal::printStats()
+DESCRIPTION:       Writes the sync policy and counters to out as one line of JSON
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void Journal::printStats(FILE* out) const {
+	static const char* names[] = {"each", "group", "async"};
+	JournalStats current = stats();
+	fprintf(out, "{\"policy\": \"%s\", \"groupBytes\": %zu, \"groupMs\": %u, \"entries\": %llu, \"bytes\": %llu, "
+	             "\"flushes\": %llu, \"avgFlushMs\": %.3f, \"maxFlushMs\": %.3f}\n",
+		names[policy], groupBytes, groupMs, (unsigned long long) current.entries,
+		(unsigned long long) current.bytes, (unsigned long long) current.flushes,
+		current.flushes ? current.flushNanos / 1e6 / current.flushes : 0.0, current.maxFlushNanos / 1e6);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parseJournalSync()
+DESCRIPTION:       Turns "each", "group" or "async" into a JournalSync
+RETURNS:           true if name was one of those, false otherwise
+----------------------------------------------------------------------------- */
+bool parseJournalSync(const char* name, JournalSync* sync) {
+	if(!strcmp(name, "each")) *sync = JOURNAL_SYNC_EACH;
+	else if(!strcmp(name, "group")) *sync = JOURNAL_SYNC_GROUP;
+	else if(!strcmp(name, "async")) *sync = JOURNAL_SYNC_ASYNC;
+	else return false;
+	return true;
+}
@@ -0,0 +1,155 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              journal.h
+
+DESCRIPTION:       An append-only log of every change made to the accounts since the database file was last saved
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __JOURNAL_H__
+#define __JOURNAL_H__
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <stdint.h>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "account.h"
+#include "accounttable.h"
+
+//The journal for a database file is the database's file name with this added to the end
+#define JOURNAL_SUFFIX ".journal"
+//A checkpoint writes the journal's replacement here before putting it in place. See Journal::rebase()
+#define JOURNAL_NEXT_SUFFIX ".next"
+#define JOURNAL_MAGIC "BANKJRNL"
+#define JOURNAL_MAGIC_LENGTH 8
+#define JOURNAL_VERSION 4
+#define JOURNAL_ERROR_LENGTH 100
+
+//Default thresholds for grouped and asynchronous syncing
+//A flush happens as soon as this many bytes are waiting...
+#define JOURNAL_GROUP_BYTES (64 * 1024)
+//...or this many milliseconds after the first entry started waiting
+#define JOURNAL_GROUP_MS 0
+#define JOURNAL_ASYNC_MS 100
+
+using namespace std;
+
+//The kinds of changes which get logged
+enum JournalOp {
+	JOURNAL_DEPOSIT = 1,
+	JOURNAL_WITHDRAW,
+	JOURNAL_TRANSFER,
+	JOURNAL_OPEN,
+	JOURNAL_CLOSE
+};
+
+//When logged changes have to reach the disk
+enum JournalSync {
+	//Every change is written and synced before logging it returns
+	JOURNAL_SYNC_EACH,
+	//Changes which are logged while a sync is under way wait for the next one together,
+	//so many threads logging at once share syncs. Logging still returns once the change is on disk
+	JOURNAL_SYNC_GROUP,
+	//Changes are written and synced in the background. Logging returns straight away,
+	//and anything logged within the last sync interval can be lost in a crash
+	JOURNAL_SYNC_ASYNC
+};
+
+//Counters for tuning the sync policy
+struct JournalStats {
+	uint64_t entries;
+	uint64_t bytes;
+	//Each flush is one write and one sync
+	uint64_t flushes;
+	uint64_t flushNanos;
+	uint64_t maxFlushNanos;
+};
+
+//Identifies the database file a journal was started on top of
+//If the database file has been saved since, the journal is already part of it.
+//Binary files are saved in place, so for them it's the generation in the file instead of its size and time
+struct JournalBase {
+	uint64_t size;
+	int64_t mtimeSec;
+	int64_t mtimeNsec;
+	uint64_t inode;
+	uint64_t generation;
+};
+
+struct JournalHeader {
+	char magic[JOURNAL_MAGIC_LENGTH];
+	uint32_t version;
+	uint32_t reserved;
+	JournalBase base;
+};
+
+//Every entry starts with this, followed by length bytes of data
+struct JournalEntryHeader {
+	uint32_t length;
+	//Checksum of op and the data, so that an entry which was only half written can be spotted
+	uint32_t checksum;
+	uint32_t op;
+};
+
+//Entries hold the balances after the change as well as the amount, so replaying an entry
+//which is already in the database file changes nothing
+class Journal {
+	private:
+		int fd;
+		string fileName;
+
+		JournalSync policy;
+		size_t groupBytes;
+		unsigned int groupMs;
+
+		//Everything below is guarded by lock
+		mutable mutex lock;
+		//Tells the flusher there's work to do, and tells loggers a flush has finished
+		condition_variable wake, flushed;
+		thread flusher;
+		//Entries waiting to be flushed, and when the first of them was logged
+		vector<char> buffer;
+		chrono::steady_clock::time_point bufferStart;
+		//Entries are numbered as they're logged. durable is the number of the last one on disk
+		uint64_t logged, durable;
+		//Bytes of entries logged since the journal was started, whether they've been written out yet or not
+		uint64_t loggedBytes;
+		bool flushing, stopping, failed;
+		JournalStats counters;
+
+		bool append(JournalOp, const char*, uint32_t);
+		bool write(const char*, size_t);
+		void flushLoop();
+		void stopFlusher();
+		bool replay(const char*, size_t, AccountTable*);
+	public:
+		Journal();
+		~Journal() { close(); }
+
+		void setPolicy(JournalSync, size_t, unsigned int);
+		bool open(const char*, AccountTable*, char*);
+		bool reset(const char*);
+		uint64_t mark() const;
+		bool rebase(const char*, const char*, uint64_t);
+		void close();
+
+		bool logDeposit(AccKey, Cents, Cents);
+		bool logWithdraw(AccKey, Cents, Cents);
+		bool logTransfer(AccKey, AccKey, Cents, Cents, Cents);
+		bool logOpen(const Account&);
+		bool logClose(AccKey);
+
+		JournalStats stats() const;
+		void printStats(FILE*) const;
+};
+
+bool parseJournalSync(const char*, JournalSync*);
+bool getDatabaseBase(const char*, JournalBase*);
+
+#endif
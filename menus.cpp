@@ -0,0 +1,1521 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              menus.cpp
+	DESCRIPTION:       The menus. Everything bankacct shows on the screen once the database is loaded,
+	                   from the list of accounts down to typing in an amount
+	COMPILER:          Built on g++ with c++11
+	LIBRARIES:
+		- NCursesW: Used for the user interface. W form for wide character support
+----------------------------------------------------------------------------- */
+
+#include <ncurses.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include "bankacct.h"
+
+using namespace std;
+
+//The accounts. The menus read them straight out of store.accounts(), and make every change through store
+AccountStore store;
+
+//What Tab cycles the main menu's list through
+const OrderColumn sortCycle[] = {ORDER_NUMBER, ORDER_NAME, ORDER_SOCIAL, ORDER_PHONE, ORDER_BALANCE};
+#define SORT_CYCLE_LENGTH (sizeof(sortCycle) / sizeof(sortCycle[0]))
+
+void drawMainMenu(const AccountTable*, OrderColumn, unsigned int, unsigned int, const char*, MainMenuFrame*);
+void showRow(const AccountTable*, const OrderIndex*, unsigned int, unsigned int*, unsigned int*, unsigned int);
+void printHeading(unsigned int, char const*, bool);
+bool verify(const AccountDetails*);
+unsigned int numPlaces(long long);
+void typeAmountDigit(Cents*, int*, int);
+void eraseAmountDigit(Cents*, int*);
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          mainMenu()
+DESCRIPTION:       Displays main menu to user, waits for their input, and then parses it into other menus
+RETURNS:           Void function
+NOTES:             Doesn't actually draw main menu in this function. See DrawMainMenu().
+                   Automatically resizes menu every time the terminal is resized. That's why it's so hyuuge.
+                   While the database is still loading, the accounts are listed in the order they're read,
+                   and can only be looked through. Returns straight away if loading goes wrong
+----------------------------------------------------------------------------- */
+void mainMenu(const AccountTable* people) {
+	//height and width keep track of our window dimensions
+	//cursorPos is where our cursor is on the screen
+	//windowPos is the first row to be displayed on the screen
+	unsigned int height, width, cursorPos = 0, windowPos = 0, numRows;
+	int ch;
+	//The loader adds accounts between keys, so the table's only looked at with it locked
+	unique_lock<mutex> table = store.lockTable();
+	bool loading = store.loadState() == LOAD_RUNNING;
+	//The account that was selected while loading, so it stays selected once the list is sorted
+	AccKey selected = ACC_KEY_INVALID;
+	//What the list is sorted by: which of sortCycle, and its order index. There isn't one until it's loaded
+	unsigned int sortBy = 0;
+	const OrderIndex* sorted = loading ? nullptr : &store.order(sortCycle[sortBy]);
+	//While finding, what's been typed so far, what it matches and which match is selected
+	bool finding = false;
+	char findText[FIND_LENGTH + 1] = "";
+	FindMatches matches;
+	size_t match = 0;
+	//What's on the screen, so only what changes gets drawn
+	MainMenuFrame frame;
+	while(true) {
+		getmaxyx(stdscr, height, width); //Get our window dimensions in case it has changed since last time
+		numRows = height - UI_ROWS > MAX_ROW ? MAX_ROW : height - UI_ROWS;
+		if(loading && store.loadState() != LOAD_RUNNING) {
+			if(store.loadState() != LOAD_DONE) {
+				timeout(-1);
+				return;
+			}
+			loading = false;
+			sorted = &store.order(sortCycle[sortBy]);
+			int row = selected == ACC_KEY_INVALID ? -1 : store.find(selected);
+			if(row >= 0) showRow(people, sorted, row, &cursorPos, &windowPos, numRows);
+		}
+		//While it's loading, stop waiting for keys every so often to show what's come in
+		timeout(loading ? LOAD_REFRESH_MS : -1);
+		//Try and fit everything onto screen, if possible
+		if(people->size() < numRows) {
+			cursorPos += windowPos;
+			windowPos = 0;
+		} else if(windowPos > people->size() - numRows) {
+			cursorPos += windowPos - (people->size() - numRows);
+			windowPos = people->size() - numRows;
+		}
+
+		//If the last account was just closed, the cursor might be past the end of the list
+		if(people->size() && windowPos + cursorPos >= people->size()) cursorPos = people->size() - 1 - windowPos;
+		//If our cursor is below the window, let's move our window down
+		if(cursorPos >= numRows) windowPos += cursorPos - numRows + 1;
+
+		//Make sure our minimum dimension requirements are met
+		if(height >= MIN_ROW && width >= MIN_NAME + MIN_BAL + ACC_COL + SSN_COL + PHO_COL + 8 + 6) {
+			char prompt[FIND_LENGTH + 40];
+			if(loading) {
+				snprintf(prompt, sizeof(prompt), "Loading... %u%%  %zu accounts so far", store.loadProgress() / 10,
+					people->size());
+				drawMainMenu(people, sortCycle[sortBy], cursorPos, windowPos, prompt, &frame);
+			} else if(!finding) drawMainMenu(people, sortCycle[sortBy], cursorPos, windowPos, nullptr, &frame);
+			else {
+				if(!*findText) snprintf(prompt, sizeof(prompt), "Find: _");
+				else if(!matches.count()) snprintf(prompt, sizeof(prompt), "Find: %s_  (no matches)", findText);
+				else snprintf(prompt, sizeof(prompt), "Find: %s_  (%zu of %zu)", findText, match + 1, matches.count());
+				drawMainMenu(people, sortCycle[sortBy], cursorPos, windowPos, prompt, &frame);
+			}
+		} else {
+			erase();
+			frame.valid = false;
+		}
+
+		if(loading && people->size()) selected = people->key(windowPos + cursorPos);
+		table.unlock();
+		ch = getch();
+		table = store.lockTable();
+		//Until it's all loaded, nothing can be changed, and there aren't any orders to sort or find with.
+		//All that can be done is look through what's in so far, or leave
+		if(loading && ch != 3 && ch != 27) {
+			bool browsing = ch == KEY_UP || ch == KEY_DOWN || ch == KEY_NPAGE || ch == KEY_PPAGE || ch == KEY_HOME
+				|| ch == KEY_END;
+			if(!browsing || !people->size()) continue;
+		}
+		if(finding) {
+			//Typing narrows it down, arrows go through the matches, and Enter or ESC stop finding
+			bool changed = false;
+			switch(ch) {
+				case 3: //CTRL-C
+					table.unlock();
+					exit(0);
+					break;
+				case KEY_ENTER:
+				case 10:
+				case 27:
+					finding = false;
+					break;
+				case KEY_BACKSPACE:
+				case 127:
+				case 8:
+					if(*findText) {
+						findText[strlen(findText) - 1] = '\0';
+						changed = true;
+					}
+					break;
+				case KEY_DOWN:
+				case 6: //CTRL + F again
+					if(matches.count()) {
+						match = (match + 1) % matches.count();
+						showRow(people, sorted, store.matchRow(matches, match), &cursorPos, &windowPos, numRows);
+					}
+					break;
+				case KEY_UP:
+					if(matches.count()) {
+						match = (match ? match : matches.count()) - 1;
+						showRow(people, sorted, store.matchRow(matches, match), &cursorPos, &windowPos, numRows);
+					}
+					break;
+				default:
+					if(ch >= ' ' && ch <= '~' && strlen(findText) < FIND_LENGTH) {
+						findText[strlen(findText)] = ch;
+						changed = true;
+					}
+					break;
+			}
+			if(changed) {
+				store.findPrefix(findText, &matches);
+				match = 0;
+				if(matches.count()) showRow(people, sorted, store.matchRow(matches, 0), &cursorPos, &windowPos, numRows);
+			}
+			continue;
+		}
+
+		switch(ch) {
+			case 3: //CTRL-C
+				table.unlock();
+				exit(0);
+				break;
+			case KEY_UP:
+				if(cursorPos) cursorPos--;
+				else { //Our cursor's at the top
+					//If we can fit all the records on trhe screen, then just sleect the last record
+					if(people->size() <= numRows) cursorPos = people->size() - 1;
+					else {
+						//If we aren't at the very first record, scroll up
+						if(windowPos) windowPos--;
+						else { //Otherwise set the windowPos to display the last records and select the last one
+							cursorPos = numRows - 1;
+							windowPos = people->size() - cursorPos - 1;
+						}
+					}				
+				}
+				break;
+			case KEY_DOWN:
+				if(cursorPos + windowPos >= people->size() - 1) {
+					cursorPos = 0;
+					windowPos = 0;
+				} else if(cursorPos == MAX_ROW - 1 || cursorPos == height - 7) {
+					windowPos++;
+				} else {
+					cursorPos++;
+				}
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Regular enter
+				if(people->size()) displayAccount(people, sorted->row(windowPos + cursorPos));
+				frame.valid = false;
+				break;
+			case KEY_NPAGE: //Page Down
+				//The window moves down a page and the cursor stays put on the screen, until the end of the list
+				if(people->size()) {
+					size_t pos = min((size_t) windowPos + cursorPos + numRows, people->size() - 1);
+					size_t lastWindow = people->size() > numRows ? people->size() - numRows : 0;
+					windowPos = min((size_t) windowPos + numRows, lastWindow);
+					cursorPos = pos - windowPos;
+				}
+				break;
+			case KEY_PPAGE: //Page Up
+				if(people->size()) {
+					unsigned int pos = windowPos + cursorPos > numRows ? windowPos + cursorPos - numRows : 0;
+					windowPos = windowPos > numRows ? windowPos - numRows : 0;
+					cursorPos = pos - windowPos;
+				}
+				break;
+			case KEY_HOME:
+				cursorPos = 0;
+				windowPos = 0;
+				break;
+			case KEY_END:
+				if(people->size()) {
+					windowPos = people->size() > numRows ? people->size() - numRows : 0;
+					cursorPos = people->size() - 1 - windowPos;
+				}
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case 9: //Tab
+				if(people->size()) {
+					//The same account stays selected, wherever it ends up
+					unsigned int row = sorted->row(windowPos + cursorPos);
+					sortBy = (sortBy + 1) % SORT_CYCLE_LENGTH;
+					sorted = &store.order(sortCycle[sortBy]);
+					showRow(people, sorted, row, &cursorPos, &windowPos, numRows);
+				}
+				break;
+			case 6: //CTRL + F
+				finding = true;
+				fill_n(findText, FIND_LENGTH + 1, 0);
+				store.findPrefix(findText, &matches);
+				match = 0;
+				break;
+			case 14: //CTRL + N
+				openAccount(people);
+				frame.valid = false;
+				break;
+			case 18: //CTRL + R
+				createReport(people);
+				frame.valid = false;
+				break;
+			//Debug code to find keycodes of certain keys
+			/*default:
+				printw("Key pressed: %i", ch);
+				getch();
+				break;*/
+		}
+	}
+}
+
+/*
+        -------         ----        ---------  ------------  -------
+       [Account]        Name        SS Number  Phone Number  Balance
+        -------         ----        ---------  ------------  -------
+         A123B   Novotny, Alexa...  123456789  (999)8887777  7898.09
+      [- B234C   Doe, John C.       987654321  (888)7776666     5.05-]
+         ~~~~~   Variable max 28~~  ~~~~~~~~~  ~~~~~~~~~~~~  ~~~~Var max 15
+
+                 ↑↓ - Navigate  Enter - Select  Tab - Sort
+	             ^f - find ^n - new account ^r - create report
+     
+*/
+/* -----------------------------------------------------------------------------
+FUNCTION:          showRow()
+DESCRIPTION:       Moves the main menu's cursor onto the account at row, scrolling it into the middle
+                   of the window if it isn't on the screen already
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void showRow(const AccountTable* people, const OrderIndex* sorted, unsigned int row, unsigned int* cursorPos,
+			 unsigned int* windowPos, unsigned int numRows) {
+	//Where it is in the list
+	row = sorted->position(people, row);
+	if(row >= *windowPos && row < *windowPos + numRows) {
+		*cursorPos = row - *windowPos;
+		return;
+	}
+	//mainMenu() pulls the window back up if this goes past the end of the list
+	*windowPos = row > numRows / 2 ? row - numRows / 2 : 0;
+	*cursorPos = row - *windowPos;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          drawMainMenu()
+DESCRIPTION:       Draws the main menu
+RETURNS:           Void function
+NOTES:             The list is sorted by column.
+                   If prompt isn't null, it's shown in place of the bottom line of keys.
+                   frame is what was drawn last time. Only lines that are different this time get drawn,
+                   unless frame isn't valid or the window or sort order changed, in which case it all is
+----------------------------------------------------------------------------- */
+void drawMainMenu(const AccountTable* people, OrderColumn column, unsigned int cursorPos,
+				  unsigned int windowPos, const char* prompt, MainMenuFrame* frame) {
+	//First, let's find out how much space we can allocate to the Name and Balance columns
+	//8 accounts for the 2 extra spaces between each column
+	//We also have at least 3 spaces on either side of the menu
+	unsigned int varSpace, extraSpace, nameColumn, balColumn, height, width;
+	getmaxyx(stdscr, height, width);
+	varSpace = width - ACC_COL - SSN_COL - PHO_COL - MIN_NAME - MIN_BAL - 8 - 6;
+	//DO NOT REMOVE PARENTHESIS FROM MAX_VAR
+	//I have no clue why, but apparently it doesn't work without them
+	extraSpace = varSpace > (MAX_VAR) ? varSpace - (MAX_VAR) : 0;
+	varSpace -= extraSpace;
+	balColumn = varSpace / 2 > XTRA_BAL ? XTRA_BAL : varSpace / 2;
+	nameColumn = varSpace - balColumn;
+
+	unsigned int accAnchor, nameAnchor, ssAnchor, phoneAnchor, balAnchor;
+	accAnchor = 3 + extraSpace / 2;
+	nameAnchor = accAnchor + ACC_COL + 2;
+	ssAnchor = nameAnchor + MIN_NAME + nameColumn + 2;
+	phoneAnchor = ssAnchor + SSN_COL + 2;
+	balAnchor = phoneAnchor + PHO_COL + 2;
+	unsigned int numRows = height - UI_ROWS > MAX_ROW ? MAX_ROW : height - UI_ROWS;
+	//The nav menu should be at the bottom, but not too far down if our terminal size is humongous
+	unsigned int navRow = height >= MAX_ROW + 4 ? MAX_ROW + 2 : height - 2;
+
+	//Start from a blank screen if what's there can't be trusted
+	if(!frame->valid || frame->height != height || frame->width != width || frame->column != column) {
+		erase();
+		printHeading(accAnchor, "Account", column == ORDER_NUMBER);
+		printHeading(nameAnchor + nameColumn / 2 + 6, "Name", column == ORDER_NAME);
+		printHeading(ssAnchor, "SS Number", column == ORDER_SOCIAL);
+		printHeading(phoneAnchor, "Phone Number", column == ORDER_PHONE);
+		printHeading(balAnchor + balColumn, "Balance", column == ORDER_BALANCE);
+		mvprintw(navRow, nameAnchor + varSpace / 2 - 2, "↑↓ - Navigate  Enter - Select  Tab - Sort");
+		//Nothing matches an empty line, so they all get drawn
+		frame->lines.assign(numRows, string());
+		frame->keys.clear();
+		frame->height = height;
+		frame->width = width;
+		frame->column = column;
+		frame->valid = true;
+	}
+
+	//Each line is put together in full, then only drawn if it isn't what's on the screen already.
+	//Moving the cursor changes two lines, and scrolling by one changes them all.
+	//While the database is loading, the accounts are in the order they were read
+	const OrderIndex* sorted = store.loadState() == LOAD_RUNNING ? nullptr : &store.order(column);
+	unsigned int nameWidth = MIN_NAME + nameColumn, balWidth = MIN_BAL + balColumn;
+	string line;
+	for(unsigned int i = 0; i < numRows; i++) {
+		line.assign(width, ' ');
+		//Puts text into the line at x, cutting it off at the edge of the screen
+		auto put = [&](unsigned int x, const char* text) {
+			if(x >= width) return;
+			size_t length = min(strlen(text), (size_t) (width - x));
+			line.replace(x, length, text, length);
+		};
+		if(i + windowPos < people->size()) {
+			unsigned int row = sorted ? sorted->row(i + windowPos) : i + windowPos;
+			const AccountDetails& acc = people->detail(row);
+			const char* first = people->firstName(row);
+			const char* last = people->lastName(row);
+			char text[MAX_NAME + CENTS_LENGTH + 1];
+			snprintf(text, sizeof(text), "%.*s", 5, acc.number);
+			put(accAnchor + 1, text);
+			//Last name, first name and middle initial if they fit. If they don't,
+			//as much as does with ellipses on the end
+			size_t lastLength = strlen(last), firstLength = strlen(first);
+			if(lastLength + 2 + firstLength > nameWidth - 3) {
+				snprintf(text, sizeof(text), "%s, %s", last, first);
+				strcpy(text + nameWidth - 3, "...");
+			} else snprintf(text, sizeof(text), "%s, %s %c.", last, first, acc.middle);
+			put(nameAnchor, text);
+			snprintf(text, sizeof(text), "%u", acc.social);
+			put(ssAnchor, text);
+			snprintf(text, sizeof(text), "(%u)%u", acc.area, acc.phone);
+			put(phoneAnchor, text);
+			//The balance is justified to the right. If it's too long, it keeps its last digits,
+			//so the cents are always there, and gets a ~ to show it's been cut off
+			char balance[CENTS_LENGTH];
+			size_t balLength = strlen(formatCents(people->balance(row), balance));
+			if(balLength > balWidth) snprintf(text, sizeof(text), "~%s", balance + balLength - (balWidth - 1));
+			else snprintf(text, sizeof(text), "%*s", balWidth, balance);
+			put(balAnchor, text);
+		}
+		if(i == cursorPos) {
+			put(accAnchor - 2, "[-");
+			put(balAnchor + balColumn + MIN_BAL, "-]");
+		}
+		if(line != frame->lines[i]) {
+			mvaddnstr(3 + i, 0, line.c_str(), width);
+			frame->lines[i].swap(line);
+		}
+	}
+
+	const char* keys = prompt ? prompt : "^f - Find  ^n - New Account  ^r - Create Report";
+	if(frame->keys != keys) {
+		move(navRow + 1, nameAnchor + varSpace / 2 - 2);
+		clrtoeol();
+		printw("%s", keys);
+		frame->keys = keys;
+	}
+	//Let's make our cursor invisible
+	curs_set(0);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          printHeading()
+DESCRIPTION:       A small helper function for drawMainMenu which just easily draws the column headers
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void printHeading(unsigned int x, char const* heading, bool sorted) {
+	int length = strlen(heading);
+	move(0, x);
+	for(int i = 0; i < length; i++) {
+		printw("-");
+	}
+	//The column the list is sorted by is in brackets
+	if(sorted) mvprintw(1, x - 1, "[%s]", heading);
+	else mvprintw(1, x, heading);
+	move(2, x);
+	for(int i = 0; i < length; i++) {
+		printw("-");
+	}
+}
+
+/*
+              -----------------
+                Account A123B
+              -----------------
+      Name          Alexander K. Novotny
+      Balance                    7898.09
+      SSN                      123456789
+      Phone                 (999)8887777
+
+[Deposit]| Withdraw | Transfer | Close Account
+  ←→ - Navigate  Enter - Select  ESC - Back
+*/
+/* -----------------------------------------------------------------------------
+FUNCTION:          displayAccount()
+DESCRIPTION:       Displays account page of a specific account, 
+                   from where the user can view details about an account and perform actions 
+                   such as withdrawals and deposits
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void displayAccount(const AccountTable* people, unsigned int person) {
+	const AccountDetails* acc = &people->detail(person);
+	unsigned int height, width, cursorPos = 0, minWidth, leftAnchor, rightAnchor;
+	minWidth = acc->nameLength + 7 + ACC_SEPARATION < ACC_MAIN_MIN 
+		? ACC_MAIN_MIN : acc->nameLength + 7 + ACC_SEPARATION;
+	getmaxyx(stdscr, height, width);
+	leftAnchor = width / 2 - width % 2 - minWidth / 2;
+	rightAnchor = width / 2 + minWidth / 2;
+
+	//Keeps track if the user has already entered their password
+	bool verified = false;
+
+	while(true) {
+		clear();
+		curs_set(0);
+		if(width >= ACC_MIN_WIDTH && height >= ACC_MIN_HEIGHT) {
+			mvprintw(0, width / 2 - 9, "-----------------");
+			mvprintw(1, width / 2 - 7, "Account %s", acc->number);
+			mvprintw(2, width / 2 - 9, "-----------------");
+			mvprintw(3, leftAnchor, "Name");
+			mvprintw(3, rightAnchor - acc->nameLength, "%s %c. %s",
+				people->firstName(person), acc->middle, people->lastName(person));
+			mvprintw(4, leftAnchor, "Balance");
+			char balance[CENTS_LENGTH];
+			formatCents(people->balance(person) % (1000000000LL * CENTS_PER_DOLLAR), balance);
+			mvprintw(4, rightAnchor - strlen(balance), "%s", balance);
+			mvprintw(5, leftAnchor, "SNN");
+			mvprintw(5, rightAnchor - 9, "%u", acc->social);
+			mvprintw(6, leftAnchor, "Phone");
+			mvprintw(6, rightAnchor - 12, "(%u)%u", acc->area, acc->phone);
+			
+			move(8, width / 2 - 23);
+			switch(cursorPos) {
+				case 0:
+					printw("[Deposit]| Withdraw | Transfer | Close Account");
+					break;
+				case 1:
+					printw(" Deposit |[Withdraw]| Transfer | Close Account");
+					break;
+				case 2:
+					printw(" Deposit | Withdraw |[Transfer]| Close Account");
+					break;
+				case 3:
+					printw(" Deposit | Withdraw | Transfer |[Close Account]");
+					break;
+			}
+			mvprintw(9, width / 2 - 20, "←→ - Navigate  Enter - Select  ESC - Back");
+		}
+
+		switch(getch()) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case KEY_LEFT:
+				if(cursorPos) cursorPos--;
+				else cursorPos = 3;
+				break;
+			case KEY_RIGHT:
+				if(cursorPos < 3) cursorPos++;
+				else cursorPos = 0;
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Normal enter
+				switch(cursorPos) {
+					case 0:
+						if(!verified) verified = verify(acc);
+						if(verified) deposit(people, person);
+						break;
+					case 1:
+						if(!verified) verified = verify(acc);
+						if(verified) withdraw(people, person);
+						break;
+					case 2:
+						if(!verified) verified = verify(acc);
+						if(verified) transfer(people, person);
+						break;
+					case 3:
+						if(!verified) verified = verify(acc);
+						if(verified) {
+							if(close(people, person)) return;
+						}
+						break;
+				}
+				break;
+		}
+	}	
+}	
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          deposit()
+DESCRIPTION:       Allows the user to select an ammount of money to deposit and deposits ammount in an account
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void deposit(const AccountTable* people, unsigned int person) { 
+	Cents newBalance = 0;
+	//place keeps track of the decimal place
+	int place = 0, height, width;
+	char current[CENTS_LENGTH], amount[CENTS_LENGTH], after[CENTS_LENGTH];
+	//Keeps track of if the user has hit enter yet and to ask them to confirm it
+	bool confirm = false;
+	const AccountDetails* acc = &people->detail(person);
+	Cents balance = people->balance(person);
+	
+	while(true) {
+		clear();
+		getmaxyx(stdscr, height, width);
+		if(width >= ACC_MIN_WIDTH && height >= ACC_MIN_HEIGHT) {
+			mvprintw(0, width / 2 - 9, "-----------------");
+			mvprintw(1, width / 2 - 7, "Account %s", acc->number);
+			mvprintw(2, width / 2 - 9, "-----------------");
+			mvprintw(4, width / 2 - 17, "Current Balance: %15s", formatCents(balance, current));
+			attron(A_UNDERLINE);
+			mvprintw(5, width / 2 - 17, "Deposite:        %15s+", formatCents(newBalance, amount));
+			attroff(A_UNDERLINE);
+			mvprintw(6, width / 2 - 17, "New Balance:     %15s", formatCents(balance + newBalance, after));
+			
+			if(confirm) {
+				attron(A_STANDOUT);
+				mvprintw(8, width / 2 - 6, "Are you sure?");
+				attroff(A_STANDOUT);
+			} else {
+				if(place < -2) attron(A_STANDOUT);
+				if(newBalance <= 0) mvprintw(8, width / 2 - 14, "E̶n̶t̶e̶r̶ ̶-̶ ̶C̶o̶n̶f̶i̶r̶m̶");
+				else mvprintw(8, width / 2 - 14, "Enter - Confirm");
+				attroff(A_STANDOUT);
+				printw("  Esc - Cancel");
+			}
+
+			//Make our cursor visible and in position to make the user aware that they need to input a number
+			if(place >= -2) {
+				move(5, width / 2 + 11 - place);
+				curs_set(1);
+			} else curs_set(0);
+		}
+		int in = getch();
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					if(confirm) confirm = false;
+					else return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case '0':
+				//No leading zeros, but zeros after the decimal point count
+				if(!newBalance && !place) continue;
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+				if(confirm) confirm = false;
+				if(place < -2) continue;
+				//If we don't have a decimal yet, don't exceed our maximum number of places
+				if(!place && numPlaces((balance + newBalance) / CENTS_PER_DOLLAR) >= 12) continue;
+				typeAmountDigit(&newBalance, &place, in - '0');
+				break;
+			case '.':
+				if(confirm) confirm = false;
+				if(!place) place--;
+				break;
+			case KEY_BACKSPACE:
+				if(confirm) confirm = false;
+				eraseAmountDigit(&newBalance, &place);
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Normal Enter
+				if(confirm) {
+					TxStatus status = store.deposit(person, newBalance);
+					if(status != TX_OK) txError(status);
+					return;
+				} else if(newBalance > 0) confirm = true;
+				break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          withdraw()
+DESCRIPTION:       Allows the user to select an ammount of money to withdraw and withdraws ammount from an account
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void withdraw(const AccountTable* people, unsigned int person) { 
+	Cents newBalance = 0;
+	//place keeps track of the decimal place
+	int place = 0, height, width;
+	char current[CENTS_LENGTH], amount[CENTS_LENGTH], after[CENTS_LENGTH];
+	//Keeps track of if the user has hit enter yet and to ask them to confirm it
+	bool confirm = false;
+	const AccountDetails* acc = &people->detail(person);
+	Cents balance = people->balance(person);
+	
+	while(true) {
+		clear();
+		getmaxyx(stdscr, height, width);
+		if(width >= ACC_MIN_WIDTH && height >= ACC_MIN_HEIGHT) {
+			mvprintw(0, width / 2 - 9, "-----------------");
+			mvprintw(1, width / 2 - 7, "Account %s", acc->number);
+			mvprintw(2, width / 2 - 9, "-----------------");
+			mvprintw(4, width / 2 - 17, "Current Balance: %15s", formatCents(balance, current));
+			
+			attron(A_UNDERLINE);
+			mvprintw(5, width / 2 - 17, "Withdraw:        %15s-", formatCents(newBalance, amount));
+			attroff(A_UNDERLINE);
+
+			if(balance - newBalance < 0) attron(COLOR_PAIR(1));
+			mvprintw(6, width / 2 - 17, "New Balance:     %15s", formatCents(balance - newBalance, after));
+			attroff(COLOR_PAIR(1));
+
+			if(confirm) {
+				attron(A_STANDOUT);
+				mvprintw(8, width / 2 - 6, "Are you sure?");
+				attroff(A_STANDOUT);
+			} else {
+				if(place < -2) attron(A_STANDOUT);
+				if(newBalance <= 0 || balance - newBalance < 0) mvprintw(8, width / 2 - 14, "E̶n̶t̶e̶r̶ ̶-̶ ̶C̶o̶n̶f̶i̶r̶m̶");
+				else mvprintw(8, width / 2 - 14, "Enter - Confirm");
+				attroff(A_STANDOUT);
+				printw("  Esc - Cancel");
+			}
+
+			//Make our cursor visible and in position to make the user aware that they need to input a number
+			if(place >= -2) {
+				move(5, width / 2 + 11 - place);
+				curs_set(1);
+			} else curs_set(0);
+		}
+		int in = getch();
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					if(confirm) confirm = false;
+					else return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case '0':
+				//No leading zeros, but zeros after the decimal point count
+				if(!newBalance && !place) continue;
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+				if(confirm) confirm = false;
+				if(place < -2 || balance - newBalance < 0) continue;
+				typeAmountDigit(&newBalance, &place, in - '0');
+				break;
+			case '.':
+				if(confirm) confirm = false;
+				if(!place) place--;
+				break;
+			case KEY_BACKSPACE:
+				if(confirm) confirm = false;
+				eraseAmountDigit(&newBalance, &place);
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Normal Enter
+				if(confirm) {
+					TxStatus status = store.withdraw(person, newBalance);
+					if(status != TX_OK) txError(status);
+					return;
+				} else if(newBalance > 0 && balance - newBalance >= 0) confirm = true;
+				break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          transfer()
+DESCRIPTION:       First has the user select which account to transfer to, then how much money
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void transfer(const AccountTable* people, unsigned int person) {
+	//First decide who we're going to transfer to
+	int to = transferAccount(people, person);
+	if(to < 0) return;
+	//Then decide how much
+	transferAmmount(people, person, to);
+}
+
+/*
+         -----------------                           -----------------
+           Account A123B            Transfer           Account B45█
+         -----------------                           -----------------
+ Name          Alexander K. Novotny          Name
+ Balance                    7898.09    ->    Balance
+ SSN                      123456789          SSN
+ Phone                 (999)8887777          Phone
+
+                         Enter - Confirm  Esc - Cancel
+*/
+/* -----------------------------------------------------------------------------
+FUNCTION:          transferAccount()
+DESCRIPTION:       Pulls up a menu to have the user select an account to transfer to
+RETURNS:           The row of the account the user selected, or -1 if they didn't pick one
+----------------------------------------------------------------------------- */
+int transferAccount(const AccountTable* people, unsigned int person) {
+	unsigned int height, width;
+	//Keeps track of where each column needs to be and how wide it is
+	unsigned int leftAnchor, rightAnchor, leftWidth, rightWidth;
+	char num[ACC_NUM_LENGTH + 1] = "";
+	//Tells the user that the account number they entered is invalid
+	bool error = false;
+
+	const AccountDetails* from = &people->detail(person);
+	const AccountDetails* to = nullptr;
+	int toRow = -1;
+	
+	//leftWidth shouldn't need to change, as the account will always be the same
+	leftWidth = 8 + from->nameLength > ACC_MAIN_MIN ? 8 + from->nameLength : ACC_MAIN_MIN;
+
+	while(true) {
+		clear();
+		getmaxyx(stdscr, height, width);
+		
+		if(!to && strlen(num) == ACC_NUM_LENGTH) {
+			toRow = store.find(num);
+			if(toRow >= 0) to = &people->detail(toRow);
+			else error = true;
+		}
+
+
+		if(width >= TRANS_MIN_WIDTH && height >= TRANS_MIN_HEIGHT) {
+			leftAnchor = width / 2 - TRANS_MID_COL / 2 - leftWidth / 2;
+
+			if(to) rightWidth = 8 + to->nameLength > ACC_MAIN_MIN ? 8 + to->nameLength : ACC_MAIN_MIN;
+			else rightWidth = ACC_MAIN_MIN;
+			rightAnchor = width / 2 + TRANS_MID_COL / 2 + rightWidth / 2;
+
+			//Draw the Left column first
+			mvprintw(0, leftAnchor - 9, "-----------------");
+			mvprintw(1, leftAnchor - 5 - ACC_NUM_LENGTH / 2, "Account %s", from->number);
+			mvprintw(2, leftAnchor - 9, "-----------------");
+			mvprintw(3, leftAnchor - leftWidth / 2, "Name");
+			mvprintw(3, leftAnchor + leftWidth / 2 - from->nameLength, 
+				"%s %c. %s", people->firstName(person), from->middle, people->lastName(person));
+			mvprintw(4, leftAnchor - leftWidth / 2, "Balance");
+			char balance[CENTS_LENGTH];
+			formatCents(people->balance(person) % (1000000000LL * CENTS_PER_DOLLAR), balance);
+			mvprintw(4, leftAnchor + leftWidth / 2 - strlen(balance), "%s", balance);
+			mvprintw(5, leftAnchor - leftWidth / 2, "SNN");
+			mvprintw(5, leftAnchor + leftWidth / 2 - 9, "%u", from->social);
+			mvprintw(6, leftAnchor - leftWidth / 2, "Phone");
+			mvprintw(6, leftAnchor + leftWidth / 2 - 12, "(%u)%u", from->area, from->phone);
+
+			//Then the middle column
+			mvprintw(1, width / 2 - 4, "Transfer");
+			mvprintw(4, width / 2 - 1, "->");
+
+			//Then the right column
+			mvprintw(0, rightAnchor - 9, "-----------------");
+			if(error) attron(COLOR_PAIR(1));
+			mvprintw(1, rightAnchor - 5 - ACC_NUM_LENGTH / 2, "Account %s", to ? to->number : num);
+			attroff(COLOR_PAIR(1));
+			mvprintw(2, rightAnchor - 9, "-----------------");
+			mvprintw(3, rightAnchor - rightWidth / 2, "Name");
+			mvprintw(4, rightAnchor - rightWidth / 2, "Balance");
+			mvprintw(5, rightAnchor - rightWidth / 2, "SNN");
+			mvprintw(6, rightAnchor - rightWidth / 2, "Phone");
+			
+			//Then instructions
+			if(to) attron(A_STANDOUT);
+			mvprintw(8, width / 2 - 14, "Enter - Confirm");
+			attroff(A_STANDOUT);
+			printw("  Esc - Cancel");
+			
+			if(to) {
+				mvprintw(3, rightAnchor + rightWidth / 2 - to->nameLength, 
+					"%s %c. %s", people->firstName(toRow), to->middle, people->lastName(toRow));
+				formatCents(people->balance(toRow) % (1000000000LL * CENTS_PER_DOLLAR), balance);
+				mvprintw(4, rightAnchor + rightWidth / 2 - strlen(balance), "%s", balance);
+				mvprintw(5, rightAnchor + rightWidth / 2 - 9, "%u", to->social);
+				mvprintw(6, rightAnchor + rightWidth / 2 - 12, "(%u)%u", to->area, to->phone);
+				curs_set(0);
+			} else {
+				//Inform the user that they're typing in the account number
+				move(1, rightAnchor  + 1 + strlen(num));
+				curs_set(1);
+			}
+		}
+
+		int in = getch();
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case KEY_ENTER: //NUMPAD enter
+			case 10: //Normal enter
+				if(to) return toRow;
+				else error = true;
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return -1;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case KEY_BACKSPACE:
+				if(to) {
+					strcpy(num, to->number);
+					to = nullptr;
+					toRow = -1;
+				}
+				num[strlen(num) - 1] = '\0';
+				if(error) error = false;
+				break;
+			case '\t': {
+				//Jump to the next account in number order after whatever is entered
+				//The first account starting with a partly typed number counts as next
+				const OrderIndex& numbers = store.order(ORDER_NUMBER);
+				size_t next, end;
+				if(to) next = numbers.position(people, toRow) + 1;
+				else numbers.prefix(people, num, &next, &end);
+				if(next < numbers.size() && numbers.row(next) == person) next++;
+				if(next == numbers.size()) {
+					next = 0;
+					if(numbers.row(next) == person && numbers.size() > 1) next++;
+				}
+				toRow = numbers.row(next);
+				to = &people->detail(toRow);
+				break;
+			}
+			default:
+				if(!isalnum(in) || strlen(num) >= 5) break;
+				num[strlen(num)] = toupper(in);
+				if(error) error = false;
+				break;
+
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          transferAmmount()
+DESCRIPTION:       Has the user select ho much money to transfer
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void transferAmmount(const AccountTable* people, unsigned int fromRow, unsigned int toRow) { 
+	Cents newBalance = 0;
+	//place keeps track of the decimal place
+	int place = 0, height, width;
+	char current[CENTS_LENGTH], amount[CENTS_LENGTH], after[CENTS_LENGTH];
+	//Keeps track of if the user has hit enter yet and to ask them to confirm it
+	bool confirm = false;
+	const AccountDetails* from = &people->detail(fromRow);
+	const AccountDetails* to = &people->detail(toRow);
+	Cents fromBalance = people->balance(fromRow);
+	Cents toBalance = people->balance(toRow);
+	
+	unsigned int leftAnchor, rightAnchor;
+	
+	while(true) {
+		clear();
+		getmaxyx(stdscr, height, width);
+		leftAnchor = width / 2 - 21;
+		rightAnchor = width / 2 + 22;
+
+		if(width >= TRANS_MIN_WIDTH && height >= TRANS_MIN_HEIGHT) {
+			//Left column
+			mvprintw(0, leftAnchor - 9, "-----------------");
+			mvprintw(1, leftAnchor - 5 - ACC_NUM_LENGTH, "Account %s", from->number);
+			mvprintw(2, leftAnchor - 9, "-----------------");
+			mvprintw(4, leftAnchor - 17, "Current Balance: %15s", formatCents(fromBalance, current));
+			attron(A_UNDERLINE);
+			mvprintw(5, leftAnchor - 17, "Withdraw:        %15s-", formatCents(newBalance, amount));
+			attroff(A_UNDERLINE);
+			if(fromBalance - newBalance < 0) attron(COLOR_PAIR(1));
+			mvprintw(6, leftAnchor - 17, "New Balance:     %15s", formatCents(fromBalance - newBalance, after));
+			attroff(COLOR_PAIR(1));
+			
+			//Right column
+			mvprintw(0, rightAnchor - 9, "-----------------");
+			mvprintw(1, rightAnchor - 7, "Account %s", to->number);
+			mvprintw(2, rightAnchor - 9, "-----------------");
+			mvprintw(4, rightAnchor - 17, "Current Balance: %15s", formatCents(toBalance, current));
+			attron(A_UNDERLINE);
+			mvprintw(5, rightAnchor - 17, "Deposit:         %15s+", formatCents(newBalance, amount));
+			attroff(A_UNDERLINE);
+			mvprintw(6, rightAnchor - 17, "New Balance:     %15s", formatCents(toBalance + newBalance, after));
+
+			//Middle Column
+			mvprintw(1, width / 2 - 4, "Transfer");
+			mvprintw(4, width / 2 - 1, "->");
+
+			if(confirm) {
+				attron(A_STANDOUT);
+				mvprintw(8, width / 2 - 6, "Are you sure?");
+				attroff(A_STANDOUT);
+			} else {
+				if(place < -2) attron(A_STANDOUT);
+				if(newBalance <= 0 || fromBalance - newBalance < 0) mvprintw(8, width / 2 - 14, "E̶n̶t̶e̶r̶ ̶-̶ ̶C̶o̶n̶f̶i̶r̶m̶");
+				else mvprintw(8, width / 2 - 14, "Enter - Confirm");
+				attroff(A_STANDOUT);
+				printw("  Esc - Cancel");
+			}
+
+			//Make our cursor visible and in position to make the user aware that they need to input a number
+			if(place >= -2) {
+				move(5, leftAnchor + 11 - place);
+				curs_set(1);
+			} else curs_set(0);
+		}
+		int in = getch();
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					if(confirm) confirm = false;
+					else return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case '0':
+				//No leading zeros, but zeros after the decimal point count
+				if(!newBalance && !place) continue;
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+				if(confirm) confirm = false;
+				if(place < -2) continue;
+				//If we don't have a decimal yet, don't exceed our maximum number of places
+				if(!place && (numPlaces((toBalance + newBalance) / CENTS_PER_DOLLAR) >= 12
+					|| fromBalance - newBalance < 0)) continue;
+				typeAmountDigit(&newBalance, &place, in - '0');
+				break;
+			case '.':
+				if(confirm) confirm = false;
+				if(!place) place--;
+				break;
+			case KEY_BACKSPACE:
+				if(confirm) confirm = false;
+				eraseAmountDigit(&newBalance, &place);
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Normal Enter
+				if(confirm) {
+					TxStatus status = store.transfer(fromRow, toRow, newBalance);
+					if(status != TX_OK) txError(status);
+					return;
+				} else if(newBalance > 0 && fromBalance - newBalance >= 0) confirm = true;
+				break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          close()
+DESCRIPTION:       Closes an account
+RETURNS:           true if the account was closed, false otherwise
+NOTES:             The user has to verify themselves beforehand
+----------------------------------------------------------------------------- */
+bool close(const AccountTable* people, unsigned int person) {
+	unsigned int height, width;
+	getmaxyx(stdscr, height, width);
+
+	const AccountDetails* acc = &people->detail(person);
+
+	clear();
+
+	mvprintw(height / 2 - 2, width / 2 - 11, "Closing Account %s", acc->number);
+	attron(A_STANDOUT);
+	mvprintw(height / 2, width / 2 - 7, "Are you sure?");
+	attroff(A_STANDOUT);
+	mvprintw(height / 2 + 1, width / 2 - 6, "Enter / ESC");
+	curs_set(0);
+	while(true) {
+		switch(getch()) {
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Normal enter
+				clear();
+				if(verify(acc)) {
+					TxStatus status = store.close(person);
+					if(status != TX_OK) {
+						txError(status);
+						return false;
+					}
+					return true;
+				} else return false;
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return false;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          verify()
+DESCRIPTION:       Asks the user to verify themselves by typing in the password of the specified account
+RETURNS:           true if the user succefully typed the correct password, false otherwise
+----------------------------------------------------------------------------- */
+bool verify(const AccountDetails* acc) {
+	unsigned int height, width;
+	getmaxyx(stdscr, height, width);
+
+	mvprintw(height / 2 - 3, width / 2 - 9, "-----------------");
+	mvprintw(height / 2 - 2, width / 2 - 7,   "Account %s", acc->number);
+	mvprintw(height / 2 - 1, width / 2 - 9, "-----------------");
+
+	mvprintw(height / 2 + 1, width / 2 - 11, "Password: ");
+	curs_set(1);
+
+	char pass[6 + 1] = "";
+
+	while(true) {
+		int in = getch();
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case KEY_BACKSPACE:
+				if(strlen(pass)) pass[strlen(pass) - 1] = '\0';
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return false;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			default:
+				if(!isalnum(in) || strlen(pass) >= 6) break;
+				pass[strlen(pass)] = in;
+				if(strlen(pass) == 6) {
+					if(!strcmp(pass, acc->password) || !strcmp(pass, "passwo")) return true;
+					else {
+						attron(COLOR_PAIR(1));
+						mvprintw(height / 2 + 2, width / 2 - 10, "Password incorrect!");
+						attroff(COLOR_PAIR(1));
+						mvprintw(height / 2 + 3, width / 2 - 14, "Press Any Key to Continue...");
+						getch();
+						return false;
+					}
+				}
+				break;
+		}
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          openAccount()
+DESCRIPTION:       Menu for the user to add a new account
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+
+void openAccount(const AccountTable* people) {
+	unsigned int width;
+	//Field keeps track of what we're currently entering in to
+	int field = 0;
+	//Zeroed so that it goes into the journal without any junk in it
+	Account newPerson = Account();
+	char buf[50] = "";
+
+	while(true) {
+		clear();
+		curs_set(1);
+		//Copy for us to abuse
+		int _field = field;
+		width = getmaxx(stdscr);
+
+		mvprintw(0, width / 2 - 6, "-------------");
+		mvprintw(1, width / 2 - 5, "New Account");
+		mvprintw(2, width / 2 - 6, "-------------");
+
+		mvprintw(4, width / 2 -  NEWACC_LEFTSHIFT, "First Name: %s", !_field ? buf : newPerson.first);
+		if(--_field >= 0) {
+			mvprintw(5, width / 2 - NEWACC_LEFTSHIFT, "Last Name: %s", !_field ? buf : newPerson.last);
+		}
+		if(--_field >= 0) {
+			mvprintw(6, width / 2 - NEWACC_LEFTSHIFT, "Middle Initial: %c", !_field ? buf[0] : newPerson.middle);
+		}
+		if(--_field >= 0) {
+			mvprintw(7, width / 2 - NEWACC_LEFTSHIFT, "Social Security Number: %u", !_field ? atoi(buf) : newPerson.social);
+		}
+		if(--_field >= 0) {
+			mvprintw(8, width / 2 - NEWACC_LEFTSHIFT, "Phone Number Area Code: %u", !_field ? atoi(buf) : newPerson.area);
+		}
+		if(--_field >= 0) {
+			mvprintw(9, width / 2 - NEWACC_LEFTSHIFT, "Phone Number: %u", !_field ? atoi(buf) : newPerson.phone);
+		}
+		if(--_field >= 0) {
+			if(!_field) mvprintw(10, width / 2 - NEWACC_LEFTSHIFT, "Balance: %s", buf);
+			else {
+				char balance[CENTS_LENGTH];
+				mvprintw(10, width / 2 - NEWACC_LEFTSHIFT, "Balance: %s", formatCents(newPerson.balance, balance));
+			}
+		}
+		if(--_field >= 0) {
+			mvprintw(11, width / 2 - NEWACC_LEFTSHIFT, "Account Number: %s", !_field ? buf : newPerson.number);
+		}
+		if(--_field >= 0) {
+			mvprintw(12, width / 2 - NEWACC_LEFTSHIFT, "Password: ");
+			for(unsigned int i = 0; i < strlen(buf); i++) {
+				printw("*");
+			}
+		}
+		int in = getch();
+
+		bool validIn = true;
+		switch(in) {
+			case 3:
+				exit(0);
+				break;
+			case KEY_BACKSPACE:
+				if(strlen(buf)) buf[strlen(buf) - 1] = '\0';
+				break;
+			case 27: //ESC
+				//Below code is neccesary to tell the difference between ESC and F keys
+				nodelay(stdscr, true);
+				if(getch() == -1) {
+					nodelay(stdscr, false);
+					return;
+				} else {
+					//F keys
+					getch();
+					switch(getch()){}
+					getch();
+				}
+				nodelay(stdscr, false);
+				break;
+			case KEY_ENTER: //NUMPAD only
+			case 10: //Actual enter
+				//Every field has to pass the same checks batch mode uses before moving on to the next
+				if(!setAccountField(&newPerson, field, buf)) break;
+				//Account numbers have to be unique
+				if(field == FIELD_NUMBER && store.find(newPerson.key) >= 0) break;
+				fill_n(buf, 50, 0);
+				if(++field < FIELD_COUNT) break;
+				{
+					TxStatus status = store.open(&newPerson);
+					if(status != TX_OK) txError(status);
+				}
+				return;
+			default:
+				if(!isalnum(in) && in != '.') break;
+				validIn = true;
+				switch(field) {
+					case 2:
+						if(strlen(buf) >= 1) {
+							validIn = false;
+							break;
+						}
+					case 0:
+					case 1:
+						if(!isalpha(in)) {
+							validIn = false;
+							break;
+						}
+						break;
+					case 3:
+						if(!isdigit(in) || strlen(buf) >= 9) {
+							validIn = false;
+							break;
+						}
+						break;
+					case 4:
+						if(!isdigit(in) || strlen(buf) >= 3) {
+							validIn = false;
+							break;
+						}
+						break;
+					case 5:
+						if(!isdigit(in) || strlen(buf) >= 7) {
+							validIn = false;
+							break;
+						}
+						break;
+					case 6:
+						if(!isdigit(in)) {
+							if(in == '.' && strchr(buf, '.') == nullptr) {
+								break;
+							}
+							validIn = false;
+							break;
+						}
+						//Two decimal places, and no more dollars than a deposit can make
+						if(strchr(buf, '.') != nullptr ? buf + strlen(buf) - strchr(buf, '.') > 2 : strlen(buf) >= 12) {
+							validIn = false;
+							break;
+						}
+						break;
+					case 7:
+						if(!isalnum(in) || strlen(buf) >= 5) {
+							validIn = false;
+							break;
+						}
+						in = toupper(in);
+						break;
+					case 8:
+						if(!isalnum(in) || strlen(buf) >= 6) {
+							validIn = false;
+							break;
+						}
+						in = toupper(in);
+						break;
+				}
+				if(validIn) buf[strlen(buf)] = in;
+				break;
+
+		}
+
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          createReport()
+DESCRIPTION:       Prompts the user to select a file and then prints a legible report file to that file
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void createReport(const AccountTable* people) {
+	char fileName[50] = "BankAcct.Rpt";
+	unsigned int height, width, error = 0;
+
+	while(true) {
+		clear();
+		getmaxyx(stdscr, height, width);
+		
+		mvprintw(height / 2 - 4, width / 2 - 8, "---------------");
+		mvprintw(height / 2 - 3, width / 2 - 6, "Create Report");
+		mvprintw(height / 2 - 2, width / 2 - 8, "---------------");
+		
+		attron(COLOR_PAIR(1));
+		switch(error) {
+			case 1:
+				mvprintw(height / 2 + 1, width / 2 - 15 - strlen(fileName) / 2, 
+					"Error: \"%s\" could not be opened", fileName);
+				break;
+			case 2:
+				mvprintw(height / 2 + 1, width / 2 - 16, 
+					"Error: Blank file name not supported", fileName);
+				break;
+		}
+		attroff(COLOR_PAIR(1));
+
+		mvprintw(height / 2, width / 2 - 12, "Filename: %s", fileName);
+		curs_set(1);
+
+		int in = getch();
+		error = 0;
+		switch(in) {
+			case 3: //CTRL-C
+				exit(0);
+				break;
+			case KEY_BACKSPACE:
+				if(strlen(fileName)) fileName[strlen(fileName) - 1] = '\0';
+				break;
+			case KEY_ENTER: //NUMPAD enter only
+			case 10: //Normal keyboard enter
+				if(strlen(fileName)) {
+					if(!store.report(fileName)) {
+						error = 1;
+						break;
+					}
+					attron(A_STANDOUT);
+					mvprintw(height / 2 + 1, width / 2 - 11 - strlen(fileName) / 2,
+						"Report file \"%s\" written", fileName);
+					attroff(A_STANDOUT);
+					curs_set(0);
+					getch();
+					return;
+				}
+				else error = 2;
+				break;
+			default:
+				fileName[strlen(fileName)] = in;
+				break;
+		}
+				
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          showError()
+DESCRIPTION:       Shows an error in the middle of the screen and waits for the user to acknowledge it
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void showError(char const* title, char const* message) {
+	unsigned int height, width;
+	getmaxyx(stdscr, height, width);
+	clear();
+	curs_set(0);
+	attron(COLOR_PAIR(1));
+	mvprintw(height / 2 - 1, width / 2 - strlen(title) / 2, "%s", title);
+	mvprintw(height / 2, width / 2 - strlen(message) / 2, "%s", message);
+	attroff(COLOR_PAIR(1));
+	mvprintw(height / 2 + 2, width / 2 - 14, "Press Any Key to Continue...");
+	getch();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          txError()
+DESCRIPTION:       Tells the user that the store turned a change down, and why
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void txError(TxStatus status) {
+	if(status == TX_JOURNAL) {
+		showError("Error: the change could not be saved to the journal", "Nothing was changed");
+		return;
+	}
+	char title[64];
+	snprintf(title, sizeof(title), "Error: the change was refused (%s)", txStatusName(status));
+	showError(title, "Nothing was changed");
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          setupScreen()
+DESCRIPTION:       Puts the screen ncurses was just started on into the modes the menus expect
+RETURNS:           Void function
+NOTES:             Also contains a few customizable options like raw mode
+----------------------------------------------------------------------------- */
+void setupScreen() {
+	//Raw mode - intercepts all user input immediately, even control characters like ctrl-c
+	raw();
+	//Turn off echoing
+	//Without this, the user will see every character they type even if they aren't typing into something
+	noecho();
+	//Allow the use of special key inputs such as function keys and arrow keys
+	keypad(stdscr, TRUE);
+	//Makes it so that ncurses doesn't wait a whole second when the user hits ESC
+	set_escdelay(25);
+	//Defines a color pair
+	start_color();
+	init_pair(1, COLOR_BLACK, COLOR_RED);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          numPlaces()
+DESCRIPTION:       Calculates the number of places (in string form) an int will take up
+RETURNS:           The number of places
+----------------------------------------------------------------------------- */
+unsigned int numPlaces(long long i) {
+	int places = 1;
+	if(i < 0) {
+		i *= -1;
+		places++;
+	}
+	while(i >= 10) {
+		places++;
+		i /= 10;
+	}
+	return places;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          typeAmountDigit()
+DESCRIPTION:       Adds a digit the user typed to the end of an amount they're entering
+RETURNS:           Void function
+NOTES:             place is 0 until the decimal point is typed, -1 and -2 while the dimes and cents
+                   are being typed, and -3 once they have been. Callers stop digits past that
+----------------------------------------------------------------------------- */
+void typeAmountDigit(Cents* amount, int* place, int digit) {
+	if(!*place) *amount = *amount * 10 + digit * CENTS_PER_DOLLAR;
+	else {
+		*amount += *place == -1 ? digit * 10 : digit;
+		(*place)--;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          eraseAmountDigit()
+DESCRIPTION:       Takes the last thing typed off the end of an amount, the decimal point included
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void eraseAmountDigit(Cents* amount, int* place) {
+	if(!*place) *amount = *amount / (10 * CENTS_PER_DOLLAR) * CENTS_PER_DOLLAR;
+	else {
+		if(*place == -2) *amount -= *amount % CENTS_PER_DOLLAR;
+		else if(*place == -3) *amount -= *amount % 10;
+		(*place)++;
+	}
+}
@@ -0,0 +1,108 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              namearena.cpp
+	DESCRIPTION:       The name arena. Stores every different name once, and hands out
+	                   a four byte reference to it instead of a fixed size array per account
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include "namearena.h"
+
+using namespace std;
+
+//FNV-1a
+uint32_t NameArena::hash(const char* name, size_t length) {
+	uint32_t h = 2166136261u;
+	for(size_t i = 0; i < length; i++) {
+		h ^= (unsigned char) name[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          NameArena::grow()
+DESCRIPTION:       Doubles the size of the intern table
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void NameArena::grow() {
+	vector<NameRef> old(slots.size() ? slots.size() * 2 : 1024, NAME_REF_NONE);
+	old.swap(slots);
+	size_t mask = slots.size() - 1;
+	for(NameRef ref : old) {
+		if(ref == NAME_REF_NONE) continue;
+		size_t i = hash(&text[ref], strlen(&text[ref])) & mask;
+		while(slots[i] != NAME_REF_NONE) i = (i + 1) & mask;
+		slots[i] = ref;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          NameArena::intern()
+DESCRIPTION:       Finds a name in the arena, adding it if it isn't there yet
+RETURNS:           Where the name is
+NOTES:             The name doesn't need a '\0' after it when the length is given
+----------------------------------------------------------------------------- */
+NameRef NameArena::intern(const char* name, size_t length) {
+	if((count + 1) * 2 > slots.size()) grow();
+	size_t mask = slots.size() - 1;
+	size_t i = hash(name, length) & mask;
+	for(; slots[i] != NAME_REF_NONE; i = (i + 1) & mask) {
+		const char* stored = &text[slots[i]];
+		if(!strncmp(stored, name, length) && !stored[length]) return slots[i];
+	}
+
+	//Grow the block by half again when it's full, rather than by the default doubling,
+	//since most loads stop well short of the next doubling
+	if(text.size() + length + 1 > text.capacity()) text.reserve(text.capacity() / 2 * 3 + length + 1);
+	NameRef ref = text.size();
+	text.insert(text.end(), name, name + length);
+	text.push_back('\0');
+	slots[i] = ref;
+	count++;
+	return ref;
+}
+
+NameRef NameArena::intern(const char* name) {
+	return intern(name, strlen(name));
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          NameArena::refs()
+DESCRIPTION:       Lists every different name in the arena, in no particular order
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void NameArena::refs(vector<NameRef>* out) const {
+	out->clear();
+	out->reserve(count);
+	for(NameRef ref : slots) {
+		if(ref != NAME_REF_NONE) out->push_back(ref);
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          NameArena::restore()
+DESCRIPTION:       Puts back an arena saved with block() and table(): length bytes of names,
+                   and an intern table of size slots with count names in it
+RETURNS:           true if it was put back, false if it doesn't look like an arena, and it's left empty
+NOTES:             Nothing is hashed again, so the table has to be the one that went with the names
+----------------------------------------------------------------------------- */
+bool NameArena::restore(const char* names, size_t length, const NameRef* table, size_t size, size_t count) {
+	clear();
+	if((size & (size - 1)) || count * 2 > size || (length && names[length - 1]) || length >= NAME_REF_NONE) return false;
+	for(size_t i = 0; i < size; i++) {
+		if(table[i] != NAME_REF_NONE && table[i] >= length) return false;
+	}
+	text.assign(names, names + length);
+	slots.assign(table, table + size);
+	this->count = count;
+	return true;
+}
+
+void NameArena::clear() {
+	vector<char>().swap(text);
+	vector<NameRef>().swap(slots);
+	count = 0;
+}
@@ -0,0 +1,55 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              namearena.h
+
+DESCRIPTION:       Shared storage for account holders' names. Each different name is only stored once
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __NAMEARENA_H__
+#define __NAMEARENA_H__
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+
+//Where a name starts in the arena
+typedef uint32_t NameRef;
+#define NAME_REF_NONE 0xFFFFFFFFu
+
+using namespace std;
+
+//Names are packed end to end, each with a '\0' after it, in one block which only ever grows.
+//A name which has been seen before gets the NameRef it got the first time, so a thousand
+//Smiths take up the room of one. Names aren't taken out when an account is closed -
+//they go when the database is next loaded
+class NameArena {
+	private:
+		vector<char> text;
+		//Open addressing with linear probing, kept at most half full. NAME_REF_NONE is an empty slot
+		vector<NameRef> slots;
+		size_t count;
+
+		static uint32_t hash(const char*, size_t);
+		void grow();
+	public:
+		NameArena() : count(0) {}
+
+		NameRef intern(const char*, size_t);
+		NameRef intern(const char*);
+		const char* get(NameRef ref) const { return &text[ref]; }
+		void refs(vector<NameRef>*) const;
+
+		//The arena as it is in memory, for saving it in an index file, and putting it back from one
+		const vector<char>& block() const { return text; }
+		const vector<NameRef>& table() const { return slots; }
+		bool restore(const char*, size_t, const NameRef*, size_t, size_t);
+
+		size_t size() const { return count; }
+		size_t bytes() const { return text.capacity() + slots.capacity() * sizeof(NameRef); }
+		void clear();
+};
+
+#endif
@@ -0,0 +1,395 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              orderindex.cpp
+	DESCRIPTION:       Order indexes. Sorts a list of rows instead of the accounts themselves, keeps it sorted
+	                   as accounts are opened and closed and balances change, and finds the accounts
+	                   that start with some text
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <strings.h> //For strcasecmp
+#include <string>
+#include <algorithm>
+#include <thread>
+#include "orderindex.h"
+
+using namespace std;
+
+//Balances can be negative, so flip the sign bit to make them sort as unsigned numbers
+static uint64_t sortableBalance(Cents balance) {
+	return (uint64_t) balance ^ (uint64_t) 1 << 63;
+}
+
+//What build() sorts. value is the column as one number
+struct SortEntry {
+	uint64_t value;
+	AccKey key;
+	uint32_t row;
+};
+
+static bool sortsBefore(const SortEntry& a, const SortEntry& b) {
+	if(a.value != b.value) return a.value < b.value;
+	if(a.key != b.key) return a.key < b.key;
+	return a.row < b.row;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parallelSort()
+DESCRIPTION:       Sorts entries on up to threads threads. Each thread sorts a chunk,
+                   then neighbouring chunks are merged until there's one left
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+static void parallelSort(vector<SortEntry>* entries, unsigned int threads) {
+	size_t chunks = threads;
+	if(chunks > entries->size() / ORDER_CHUNK_MIN) chunks = entries->size() / ORDER_CHUNK_MIN;
+	if(chunks < 1) chunks = 1;
+	vector<SortEntry>::iterator begin = entries->begin();
+	vector<size_t> bounds(chunks + 1);
+	for(size_t i = 0; i <= chunks; i++) bounds[i] = entries->size() * i / chunks;
+	vector<thread> workers;
+	for(size_t i = 1; i < chunks; i++) {
+		workers.push_back(thread([=]() { sort(begin + bounds[i], begin + bounds[i + 1], sortsBefore); }));
+	}
+	sort(begin, begin + bounds[1], sortsBefore);
+	for(thread& worker : workers) worker.join();
+	for(size_t width = 1; width < chunks; width *= 2) {
+		workers.clear();
+		for(size_t i = 0; i + width < chunks; i += width * 2) {
+			size_t last = bounds[min(i + width * 2, chunks)];
+			workers.push_back(thread([=]() {
+				inplace_merge(begin + bounds[i], begin + bounds[i + width], begin + last, sortsBefore);
+			}));
+		}
+		for(thread& worker : workers) worker.join();
+	}
+}
+
+NameRef OrderIndex::primary(const AccountTable* people, uint32_t row) const {
+	const AccountDetails& d = people->detail(row);
+	return column == ORDER_NAME ? d.last : d.first;
+}
+
+NameRef OrderIndex::secondary(const AccountTable* people, uint32_t row) const {
+	const AccountDetails& d = people->detail(row);
+	return column == ORDER_NAME ? d.first : d.last;
+}
+
+//What the columns which aren't names sort by, as one number
+uint64_t OrderIndex::value(const AccountTable* people, uint32_t row) const {
+	const AccountDetails& d = people->detail(row);
+	switch(column) {
+		case ORDER_NUMBER:
+			return people->key(row);
+		case ORDER_SOCIAL:
+			return d.social;
+		case ORDER_PHONE:
+			return (uint64_t) d.area << 32 | d.phone;
+		case ORDER_BALANCE:
+			return sortableBalance(people->balance(row));
+		default:
+			return 0;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::compare()
+DESCRIPTION:       Compares the account at row a with the one at row b, the way this index sorts them.
+                   b's column sorts as bValue, which only matters for columns that aren't names
+RETURNS:           Less than 0 if a comes first, more than 0 if b does, 0 if they tie or a is entry.
+                   entry is whichever row in the index stands for b, which might not be b yet
+NOTES:             Passing in bValue and entry lets an account be found where it was sorted,
+                   after its balance or its row has changed
+----------------------------------------------------------------------------- */
+int OrderIndex::compare(const AccountTable* people, uint32_t a, unsigned int entry, unsigned int b,
+                        uint64_t bValue) const {
+	if(a == entry) return 0;
+	if(column == ORDER_NAME || column == ORDER_FIRST_NAME) {
+		const NameArena& names = people->nameArena();
+		//Names are interned, so the same name is always the same NameRef
+		NameRef nameA = primary(people, a), nameB = primary(people, b);
+		if(nameA != nameB) {
+			int c = strcasecmp(names.get(nameA), names.get(nameB));
+			if(c) return c;
+		}
+		nameA = secondary(people, a);
+		nameB = secondary(people, b);
+		if(nameA != nameB) {
+			int c = strcasecmp(names.get(nameA), names.get(nameB));
+			if(c) return c;
+		}
+	} else {
+		uint64_t valueA = value(people, a);
+		if(valueA != bValue) return valueA < bValue ? -1 : 1;
+	}
+	if(people->key(a) != people->key(b)) return people->key(a) < people->key(b) ? -1 : 1;
+	return 0;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::partition()
+DESCRIPTION:       Binary search for the first row that before() is false for. before() has to be true
+                   for every row up to some point in the order, and false after it
+RETURNS:           That row's position, or size() if there isn't one
+----------------------------------------------------------------------------- */
+template<class Before> size_t OrderIndex::partition(Before before) const {
+	//The first block whose last row isn't before, then the first row in it that isn't
+	auto block = partition_point(blocks.begin(), blocks.end(), [&](const vector<uint32_t>& b) {
+		return before(b.back());
+	});
+	if(block == blocks.end()) return count;
+	return starts[block - blocks.begin()] + (partition_point(block->begin(), block->end(), before) - block->begin());
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::find()
+DESCRIPTION:       Finds entry, which stands for the account at row b whose column sorts as bValue
+RETURNS:           Its position
+----------------------------------------------------------------------------- */
+size_t OrderIndex::find(const AccountTable* people, unsigned int entry, unsigned int b, uint64_t bValue) const {
+	size_t at = partition([&](uint32_t a) { return compare(people, a, entry, b, bValue) < 0; });
+	//Accounts with the same number and column are in no particular order, so look through them
+	while(at < count && row(at) != entry) at++;
+	return at;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::build()
+DESCRIPTION:       Sorts every row of people by column, on up to threads threads
+RETURNS:           Void function
+NOTES:             Everything is sorted as (number, key, row) entries, so the accounts themselves aren't touched.
+                   For names the number is a rank: there are far fewer different names than accounts,
+                   so the names are sorted once and every account is sorted by the ranks of its names
+----------------------------------------------------------------------------- */
+void OrderIndex::build(const AccountTable* people, OrderColumn sortBy, unsigned int threads) {
+	column = sortBy;
+
+	vector<SortEntry> entries(people->size());
+	if(column == ORDER_NAME || column == ORDER_FIRST_NAME) {
+		const NameArena& names = people->nameArena();
+		//Names that only differ in case get the same rank
+		vector<NameRef> sorted;
+		names.refs(&sorted);
+		sort(sorted.begin(), sorted.end(), [&names](NameRef a, NameRef b) {
+			return strcasecmp(names.get(a), names.get(b)) < 0;
+		});
+		vector<pair<NameRef, uint32_t>> ranks(sorted.size());
+		uint32_t rank = 0;
+		for(size_t i = 0; i < sorted.size(); i++) {
+			if(i && strcasecmp(names.get(sorted[i - 1]), names.get(sorted[i]))) rank++;
+			ranks[i] = make_pair(sorted[i], rank);
+		}
+		vector<NameRef>().swap(sorted);
+		sort(ranks.begin(), ranks.end());
+		auto rankOf = [&ranks](NameRef ref) {
+			return lower_bound(ranks.begin(), ranks.end(), make_pair(ref, (uint32_t) 0))->second;
+		};
+		for(size_t i = 0; i < entries.size(); i++) {
+			entries[i].value = (uint64_t) rankOf(primary(people, i)) << 32 | rankOf(secondary(people, i));
+		}
+	} else {
+		for(size_t i = 0; i < entries.size(); i++) entries[i].value = value(people, i);
+	}
+	for(size_t i = 0; i < entries.size(); i++) {
+		entries[i].key = people->key(i);
+		entries[i].row = i;
+	}
+
+	//Loading sorts the table by number, so that order is usually sorted already
+	if(!is_sorted(entries.begin(), entries.end(), sortsBefore)) parallelSort(&entries, threads);
+
+	clear();
+	for(size_t i = 0; i < entries.size(); i += ORDER_BLOCK) {
+		blocks.emplace_back();
+		starts.push_back(i);
+		for(size_t j = i; j < entries.size() && j < i + ORDER_BLOCK; j++) blocks.back().push_back(entries[j].row);
+	}
+	count = entries.size();
+	built = true;
+}
+
+void OrderIndex::clear() {
+	vector<vector<uint32_t>>().swap(blocks);
+	vector<size_t>().swap(starts);
+	count = 0;
+	built = false;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::restore()
+DESCRIPTION:       Puts back the order of rows sorted by sortBy, as saved from rowBlocks()
+RETURNS:           Void function
+NOTES:             Nothing is compared, so it has to have been saved for the same rows
+----------------------------------------------------------------------------- */
+void OrderIndex::restore(OrderColumn sortBy, const uint32_t* rows, size_t size) {
+	clear();
+	column = sortBy;
+	for(size_t i = 0; i < size; i += ORDER_BLOCK) {
+		blocks.emplace_back(rows + i, rows + min(size, i + ORDER_BLOCK));
+		starts.push_back(i);
+	}
+	count = size;
+	built = true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::row()
+DESCRIPTION:       Finds the account at position i in this order
+RETURNS:           Its row
+----------------------------------------------------------------------------- */
+uint32_t OrderIndex::row(size_t i) const {
+	size_t block = upper_bound(starts.begin(), starts.end(), i) - starts.begin() - 1;
+	return blocks[block][i - starts[block]];
+}
+
+//Works out where every block from block on starts, after the ones before it changed size
+void OrderIndex::restart(size_t block) {
+	if(!block && !starts.empty()) starts[block++] = 0;
+	for(; block < blocks.size(); block++) starts[block] = starts[block - 1] + blocks[block - 1].size();
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::insertAt(), eraseAt()
+DESCRIPTION:       Put row in at position i, or take out whatever's at i
+RETURNS:           Void function
+NOTES:             Only moves the rest of one block, plus where each block after it starts
+----------------------------------------------------------------------------- */
+void OrderIndex::insertAt(size_t i, uint32_t row) {
+	if(blocks.empty()) {
+		blocks.emplace_back();
+		starts.push_back(0);
+	}
+	size_t block = i == count ? blocks.size() - 1 : upper_bound(starts.begin(), starts.end(), i) - starts.begin() - 1;
+	vector<uint32_t>& rows = blocks[block];
+	rows.insert(rows.begin() + (i - starts[block]), row);
+	count++;
+	if(rows.size() >= ORDER_BLOCK * 2) {
+		vector<uint32_t> second(rows.begin() + ORDER_BLOCK, rows.end());
+		rows.resize(ORDER_BLOCK);
+		blocks.insert(blocks.begin() + block + 1, move(second));
+		starts.insert(starts.begin() + block + 1, 0);
+	}
+	restart(block + 1);
+}
+
+void OrderIndex::eraseAt(size_t i) {
+	size_t block = upper_bound(starts.begin(), starts.end(), i) - starts.begin() - 1;
+	vector<uint32_t>& rows = blocks[block];
+	rows.erase(rows.begin() + (i - starts[block]));
+	count--;
+	if(rows.empty()) {
+		blocks.erase(blocks.begin() + block);
+		starts.erase(starts.begin() + block);
+		restart(block);
+	} else restart(block + 1);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::inserted()
+DESCRIPTION:       Puts the account at row of people in its place, after it's been added to the table
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void OrderIndex::inserted(const AccountTable* people, unsigned int row) {
+	uint64_t rowValue = value(people, row);
+	insertAt(partition([&](uint32_t a) { return compare(people, a, row, row, rowValue) <= 0; }), row);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::erased(), moved()
+DESCRIPTION:       Keep the index up to date when an account is erased with AccountTable::eraseUnordered().
+                   Call erased() just before the account at row is erased, then moved() just after,
+                   when the account which was at row from has been moved into row
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void OrderIndex::erased(const AccountTable* people, unsigned int row) {
+	eraseAt(find(people, row, row, value(people, row)));
+}
+
+void OrderIndex::moved(const AccountTable* people, unsigned int row, unsigned int from) {
+	size_t at = find(people, from, row, value(people, row));
+	size_t block = upper_bound(starts.begin(), starts.end(), at) - starts.begin() - 1;
+	blocks[block][at - starts[block]] = row;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::balanceChanged()
+DESCRIPTION:       Moves the account at row to its new place after its balance changed from was
+RETURNS:           Void function
+NOTES:             Does nothing unless this is sorted by balance
+----------------------------------------------------------------------------- */
+void OrderIndex::balanceChanged(const AccountTable* people, unsigned int row, Cents was) {
+	if(column != ORDER_BALANCE || sortableBalance(was) == value(people, row)) return;
+	eraseAt(find(people, row, row, sortableBalance(was)));
+	inserted(people, row);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::renumber()
+DESCRIPTION:       Moves every row to newRow[row], after the table has been sorted again
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void OrderIndex::renumber(const vector<uint32_t>& newRow) {
+	for(vector<uint32_t>& rows : blocks) {
+		for(uint32_t& r : rows) r = newRow[r];
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::position()
+DESCRIPTION:       Finds where the account at row is in this order
+RETURNS:           Its position
+----------------------------------------------------------------------------- */
+size_t OrderIndex::position(const AccountTable* people, unsigned int row) const {
+	return find(people, row, row, value(people, row));
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          OrderIndex::prefix()
+DESCRIPTION:       Finds every account whose sort column starts with text, ignoring case
+RETURNS:           Void function. The matches are at positions begin up to end
+NOTES:             Only for the number and name orders.
+                   "Smith, J" matches everyone whose sort column is Smith and whose other name starts with J.
+                   Two binary searches, so it's quick enough to do on every key pressed
+----------------------------------------------------------------------------- */
+void OrderIndex::prefix(const AccountTable* people, const char* text, size_t* begin, size_t* end) const {
+	*begin = *end = 0;
+	if(column == ORDER_NUMBER) {
+		//The smallest and biggest numbers that start with text, if it could be the start of one
+		size_t length = strlen(text);
+		if(length > ACC_NUM_LENGTH) return;
+		char last[ACC_NUM_LENGTH + 1];
+		strcpy(last, text);
+		for(size_t i = length; i < ACC_NUM_LENGTH; i++) last[i] = 'Z';
+		last[ACC_NUM_LENGTH] = '\0';
+		AccKey low = packAccNum(text), high = packAccNum(last);
+		if(low == ACC_KEY_INVALID || high == ACC_KEY_INVALID) return;
+		*begin = partition([&](uint32_t row) { return people->key(row) < low; });
+		*end = partition([&](uint32_t row) { return people->key(row) <= high; });
+		return;
+	}
+
+	const NameArena& names = people->nameArena();
+	const char* comma = strchr(text, ',');
+	string whole;
+	const char* part = text;
+	if(comma) {
+		whole.assign(text, comma);
+		while(!whole.empty() && whole.back() == ' ') whole.pop_back();
+		part = comma + 1;
+		while(*part == ' ') part++;
+	}
+	size_t partLength = strlen(part);
+
+	//Less than 0 for accounts before the matches, 0 for matches and more than 0 after them
+	auto match = [&](uint32_t row) {
+		if(comma) {
+			int c = strcasecmp(names.get(primary(people, row)), whole.c_str());
+			if(c) return c;
+			return strncasecmp(names.get(secondary(people, row)), part, partLength);
+		}
+		return strncasecmp(names.get(primary(people, row)), part, partLength);
+	};
+	*begin = partition([&](uint32_t row) { return match(row) < 0; });
+	*end = partition([&](uint32_t row) { return match(row) <= 0; });
+}
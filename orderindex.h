@@ -0,0 +1,81 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              orderindex.h
+
+DESCRIPTION:       The accounts in some order, kept as a list of rows
+                   so the table itself never has to be re-sorted
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __ORDERINDEX_H__
+#define __ORDERINDEX_H__
+
+#include <vector>
+#include <stdint.h>
+#include "account.h"
+#include "accounttable.h"
+
+using namespace std;
+
+//The orders accounts can be listed in
+enum OrderColumn {
+	ORDER_NUMBER,
+	ORDER_NAME,       //Last name, then first name
+	ORDER_FIRST_NAME, //First name, then last name
+	ORDER_SOCIAL,
+	ORDER_PHONE,      //Area code, then number
+	ORDER_BALANCE,
+	ORDER_COUNT
+};
+
+//build() doesn't start threads for fewer rows than this each
+#define ORDER_CHUNK_MIN 65536
+//Rows per block when an index is built. A block is split in two when it gets twice as big
+#define ORDER_BLOCK 1024
+
+//Every row of an AccountTable, sorted by a column. Names are compared ignoring case,
+//and accounts that tie are in number order.
+//The rows are kept a block at a time, so putting one in or taking one out only moves part of one block
+class OrderIndex {
+	private:
+		OrderColumn column;
+		vector<vector<uint32_t>> blocks;
+		//Where each block starts in the order
+		vector<size_t> starts;
+		size_t count;
+		bool built;
+
+		NameRef primary(const AccountTable*, uint32_t) const;
+		NameRef secondary(const AccountTable*, uint32_t) const;
+		uint64_t value(const AccountTable*, uint32_t) const;
+		int compare(const AccountTable*, uint32_t, unsigned int, unsigned int, uint64_t) const;
+		template<class Before> size_t partition(Before) const;
+		size_t find(const AccountTable*, unsigned int, unsigned int, uint64_t) const;
+		void insertAt(size_t, uint32_t);
+		void eraseAt(size_t);
+		void restart(size_t);
+	public:
+		OrderIndex() : column(ORDER_NUMBER), count(0), built(false) {}
+
+		void build(const AccountTable*, OrderColumn, unsigned int);
+		void clear();
+		bool isBuilt() const { return built; }
+		size_t size() const { return count; }
+		uint32_t row(size_t) const;
+
+		void inserted(const AccountTable*, unsigned int);
+		void erased(const AccountTable*, unsigned int);
+		void moved(const AccountTable*, unsigned int, unsigned int);
+		void balanceChanged(const AccountTable*, unsigned int, Cents);
+		void renumber(const vector<uint32_t>&);
+		size_t position(const AccountTable*, unsigned int) const;
+		void prefix(const AccountTable*, const char*, size_t*, size_t*) const;
+
+		//The rows a block at a time, for saving them in an index file, and putting them back from one
+		const vector<vector<uint32_t>>& rowBlocks() const { return blocks; }
+		void restore(OrderColumn, const uint32_t*, size_t);
+};
+
+#endif
@@ -0,0 +1,99 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              sortbench.cpp
+	DESCRIPTION:       Times AccountTable::sortByNumber() against sorting whole records with std::sort and strcmp
+	USAGE:             sortbench [count ...]
+	                   Sorts count made up accounts each way, for each count given.
+	                   Without any, it does 1000000 and 10000000
+	COMPILER:          Built on g++ with c++11
+	Exit Codes:
+		- 0: All good
+		- 1: Bad arguments
+		- 2: The two sorts came out different
+
+----------------------------------------------------------------------------- */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "accounttable.h"
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          makeAccounts()
+DESCRIPTION:       Fills people with count accounts with random numbers, in no particular order
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void makeAccounts(vector<Account>* people, size_t count) {
+	people->assign(count, Account());
+	//Same numbers every run so runs can be compared
+	unsigned long long seed = 0x2545F4914F6CDD1Dull;
+	for(Account& acc : *people) {
+		seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+		unpackAccNum((seed >> 33) % 60466176, acc.number);
+		acc.key = packAccNum(acc.number);
+		snprintf(acc.first, sizeof(acc.first), "First%llu", seed % 1000);
+		snprintf(acc.last, sizeof(acc.last), "Last%llu", seed >> 20 & 0xFFFF);
+		acc.balance = seed % 1000000000;
+	}
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          millisSince()
+DESCRIPTION:       Works out how long it's been since start
+RETURNS:           Milliseconds
+----------------------------------------------------------------------------- */
+double millisSince(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+	vector<size_t> counts;
+	for(int i = 1; i < argc; i++) {
+		char* end;
+		unsigned long long count = strtoull(argv[i], &end, 10);
+		if(*end || !count || count > UINT32_MAX) {
+			fprintf(stderr, "Usage: %s [count ...]\n", argv[0]);
+			return 1;
+		}
+		counts.push_back(count);
+	}
+	if(counts.empty()) counts = {1000000, 10000000};
+
+	vector<Account> original, people;
+	AccountTable table;
+	for(size_t count : counts) {
+		makeAccounts(&original, count);
+
+		//What bankacct used to do
+		people = original;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		sort(people.begin(), people.end(), [](const Account& a, const Account& b) {
+			return strcmp(a.number, b.number) < 0;
+		});
+		double stdMs = millisSince(start);
+		vector<AccKey> expected(count);
+		for(size_t i = 0; i < count; i++) expected[i] = people[i].key;
+
+		vector<Account>().swap(people);
+		table.clear();
+		table.append(original.data(), original.size());
+		start = chrono::steady_clock::now();
+		table.sortByNumber(nullptr);
+		double radixMs = millisSince(start);
+		for(size_t i = 0; i < count; i++) {
+			if(table.key(i) != expected[i]) {
+				fprintf(stderr, "%s: sorts differ at %zu of %zu\n", argv[0], i, count);
+				return 2;
+			}
+		}
+
+		printf("{\"records\":%zu,\"std_sort_ms\":%.1f,\"radix_sort_ms\":%.1f}\n", count, stdMs, radixMs);
+		fflush(stdout);
+	}
+	return 0;
+}
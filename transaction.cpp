@@ -0,0 +1,201 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              transaction.cpp
+	DESCRIPTION:       Deposits, withdrawals, transfers, and opening and closing accounts.
+	                   Each change is checked, made, and logged to the journal. If it can't be logged,
+	                   it's undone, so the accounts in memory never get ahead of the journal
+	COMPILER:          Built on g++ with c++11
+
+----------------------------------------------------------------------------- */
+
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+#include "transaction.h"
+
+using namespace std;
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          txStatusName()
+DESCRIPTION:       Names a TxStatus, for batch mode's results file
+RETURNS:           The name
+----------------------------------------------------------------------------- */
+const char* txStatusName(TxStatus status) {
+	switch(status) {
+		case TX_OK: return "ok";
+		case TX_NO_ACCOUNT: return "no-account";
+		case TX_BAD_AMOUNT: return "bad-amount";
+		case TX_OVERDRAFT: return "overdraft";
+		case TX_TOO_BIG: return "too-big";
+		case TX_BAD_FIELD: return "bad-field";
+		case TX_TAKEN: return "taken";
+		case TX_JOURNAL: return "journal";
+		case TX_MALFORMED: return "malformed";
+		case TX_SKIPPED: return "skipped";
+		case TX_LOADING: return "loading";
+	}
+	return "unknown";
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parseAmount()
+DESCRIPTION:       Reads an amount of money the way it can be typed into the menus:
+                   digits, then optionally a '.' and up to two more digits
+RETURNS:           true if it was an amount, false otherwise
+NOTES:             Unlike parseCents(), there's no sign, no rounding, and no more than MAX_BALANCE_DIGITS dollars
+----------------------------------------------------------------------------- */
+bool parseAmount(const char* text, const char* end, Cents* value) {
+	const char* point = (const char*) memchr(text, '.', end - text);
+	const char* dollarsEnd = point ? point : end;
+	if(dollarsEnd - text > MAX_BALANCE_DIGITS) return false;
+	if(point && end - point - 1 > 2) return false;
+	for(const char* c = text; c < end; c++) {
+		if(c != point && (*c < '0' || *c > '9')) return false;
+	}
+	return parseCents(text, end, value);
+}
+
+//true if text is between min and max characters long, and every one of them passes test
+static bool allOf(const char* text, size_t min, size_t max, int (*test)(int)) {
+	size_t length = strlen(text);
+	if(length < min || length > max) return false;
+	for(size_t i = 0; i < length; i++) {
+		if(!test((unsigned char) text[i])) return false;
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          setAccountField()
+DESCRIPTION:       Checks one field of a new account and stores it in acc
+RETURNS:           true if the field was valid, false if it wasn't (and acc is left alone)
+NOTES:             field is an AccountField. Account numbers and passwords are stored in upper case.
+                   This doesn't check that the number isn't taken, since that needs the table
+----------------------------------------------------------------------------- */
+bool setAccountField(Account* acc, int field, const char* text) {
+	switch(field) {
+		case FIELD_FIRST:
+			if(!allOf(text, 3, FIRST_NAME_LENGTH, isalpha)) return false;
+			strcpy(acc->first, text);
+			break;
+		case FIELD_LAST:
+			if(!allOf(text, 3, LAST_NAME_LENGTH, isalpha)) return false;
+			strcpy(acc->last, text);
+			break;
+		case FIELD_MIDDLE:
+			if(!allOf(text, 1, 1, isalpha)) return false;
+			acc->middle = text[0];
+			break;
+		case FIELD_SOCIAL:
+			if(!allOf(text, 9, 9, isdigit)) return false;
+			acc->social = atoi(text);
+			break;
+		case FIELD_AREA:
+			if(!allOf(text, 3, 3, isdigit)) return false;
+			acc->area = atoi(text);
+			break;
+		case FIELD_PHONE:
+			if(!allOf(text, 7, 7, isdigit)) return false;
+			acc->phone = atoi(text);
+			break;
+		case FIELD_BALANCE:
+			if(!parseAmount(text, text + strlen(text), &acc->balance)) return false;
+			break;
+		case FIELD_NUMBER:
+			if(!allOf(text, ACC_NUM_LENGTH, ACC_NUM_LENGTH, isalnum)) return false;
+			for(int i = 0; i <= ACC_NUM_LENGTH; i++) acc->number[i] = toupper((unsigned char) text[i]);
+			acc->key = packAccNum(acc->number);
+			break;
+		case FIELD_PASSWORD:
+			if(!allOf(text, PASS_LENGTH, PASS_LENGTH, isalnum)) return false;
+			for(int i = 0; i <= PASS_LENGTH; i++) acc->password[i] = toupper((unsigned char) text[i]);
+			break;
+		default:
+			return false;
+	}
+	return true;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyDeposit(), applyWithdraw()
+DESCRIPTION:       Puts amount into, or takes it out of, the account at row
+RETURNS:           TX_OK if it was done, otherwise why not
+----------------------------------------------------------------------------- */
+TxStatus applyDeposit(AccountTable* people, Journal* journal, unsigned int row, Cents amount) {
+	if(amount <= 0 || amount > MAX_BALANCE) return TX_BAD_AMOUNT;
+	Cents& balance = people->balance(row);
+	if(balance > MAX_BALANCE - amount) return TX_TOO_BIG;
+	balance += amount;
+	if(!journal->logDeposit(people->key(row), amount, balance)) {
+		balance -= amount;
+		return TX_JOURNAL;
+	}
+	return TX_OK;
+}
+
+TxStatus applyWithdraw(AccountTable* people, Journal* journal, unsigned int row, Cents amount) {
+	if(amount <= 0 || amount > MAX_BALANCE) return TX_BAD_AMOUNT;
+	Cents& balance = people->balance(row);
+	if(balance - amount < 0) return TX_OVERDRAFT;
+	balance -= amount;
+	if(!journal->logWithdraw(people->key(row), amount, balance)) {
+		balance += amount;
+		return TX_JOURNAL;
+	}
+	return TX_OK;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyTransfer()
+DESCRIPTION:       Moves amount from the account at row from to the one at row to
+RETURNS:           TX_OK if it was done, otherwise why not
+NOTES:             from and to can be the same account, which changes nothing but is still logged
+----------------------------------------------------------------------------- */
+TxStatus applyTransfer(AccountTable* people, Journal* journal, unsigned int from, unsigned int to, Cents amount) {
+	if(amount <= 0 || amount > MAX_BALANCE) return TX_BAD_AMOUNT;
+	Cents& fromBalance = people->balance(from);
+	Cents& toBalance = people->balance(to);
+	if(fromBalance - amount < 0) return TX_OVERDRAFT;
+	if(from != to && toBalance > MAX_BALANCE - amount) return TX_TOO_BIG;
+	fromBalance -= amount;
+	toBalance += amount;
+	if(!journal->logTransfer(people->key(from), people->key(to), amount, fromBalance, toBalance)) {
+		fromBalance += amount;
+		toBalance -= amount;
+		return TX_JOURNAL;
+	}
+	return TX_OK;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyOpen()
+DESCRIPTION:       Adds a new account, whose fields have all been set with setAccountField()
+RETURNS:           TX_OK if it was added, otherwise why not
+NOTES:             Works out acc's nameLength. The account goes on the end of the table, so nothing else moves
+----------------------------------------------------------------------------- */
+TxStatus applyOpen(AccountTable* people, AccountIndex* index, Journal* journal, Account* acc) {
+	if(acc->key == ACC_KEY_INVALID || acc->balance < 0 || acc->balance > MAX_BALANCE) return TX_BAD_FIELD;
+	//Account numbers have to be unique
+	if(index->find(acc->key) >= 0) return TX_TAKEN;
+	acc->nameLength = strlen(acc->first) + strlen(acc->last) + 4;
+	if(!journal->logOpen(*acc)) return TX_JOURNAL;
+	people->append(*acc);
+	index->appended(people, people->size() - 1);
+	return TX_OK;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          applyClose()
+DESCRIPTION:       Closes the account at row
+RETURNS:           TX_OK if it was closed, otherwise why not
+NOTES:             Doesn't ask for the password. That's up to whoever is asking to close it.
+                   The last account in the table is moved into its row, so nothing else moves
+----------------------------------------------------------------------------- */
+TxStatus applyClose(AccountTable* people, AccountIndex* index, Journal* journal, unsigned int row) {
+	AccKey key = people->key(row);
+	if(!journal->logClose(key)) return TX_JOURNAL;
+	unsigned int last = people->size() - 1;
+	people->eraseUnordered(row);
+	index->moved(people, row, key, last);
+	return TX_OK;
+}
@@ -0,0 +1,75 @@
+/* -----------------------------------------------------------------------------
+
+FILE:              transaction.h
+
+DESCRIPTION:       The rules for changing accounts, and the code which makes the changes.
+                   Shared by the menus and by batch mode, so both accept exactly the same things
+
+COMPILER:          g++ with c++ 11
+
+----------------------------------------------------------------------------- */
+
+#ifndef __TRANSACTION_H__
+#define __TRANSACTION_H__
+
+#include "account.h"
+#include "accounttable.h"
+#include "journal.h"
+#include "index.h"
+
+//No balance can go past 12 digits of dollars. The menus have room for that and no more
+#define MAX_BALANCE ((Cents) 100000000000000LL - 1)
+#define MAX_BALANCE_DIGITS 12
+
+using namespace std;
+
+//How a change went. Anything but TX_OK means nothing was changed
+enum TxStatus {
+	TX_OK,
+	//The account number isn't in the database
+	TX_NO_ACCOUNT,
+	//Not an amount that could be typed in: negative, zero, too many digits, or past the cents
+	TX_BAD_AMOUNT,
+	//A withdrawal or transfer would leave less than nothing
+	TX_OVERDRAFT,
+	//The new balance would be past MAX_BALANCE
+	TX_TOO_BIG,
+	//A new account's details aren't valid
+	TX_BAD_FIELD,
+	//A new account's number is already in use
+	TX_TAKEN,
+	//The change couldn't be logged to the journal
+	TX_JOURNAL,
+	//Batch mode couldn't make sense of the line at all
+	TX_MALFORMED,
+	//Batch mode stopped before it got to this one
+	TX_SKIPPED,
+	//The database is still being loaded
+	TX_LOADING
+};
+
+//The fields of a new account, in the order they're typed in
+enum AccountField {
+	FIELD_FIRST,
+	FIELD_LAST,
+	FIELD_MIDDLE,
+	FIELD_SOCIAL,
+	FIELD_AREA,
+	FIELD_PHONE,
+	FIELD_BALANCE,
+	FIELD_NUMBER,
+	FIELD_PASSWORD,
+	FIELD_COUNT
+};
+
+const char* txStatusName(TxStatus);
+bool parseAmount(const char*, const char*, Cents*);
+bool setAccountField(Account*, int, const char*);
+
+TxStatus applyDeposit(AccountTable*, Journal*, unsigned int, Cents);
+TxStatus applyWithdraw(AccountTable*, Journal*, unsigned int, Cents);
+TxStatus applyTransfer(AccountTable*, Journal*, unsigned int, unsigned int, Cents);
+TxStatus applyOpen(AccountTable*, AccountIndex*, Journal*, Account*);
+TxStatus applyClose(AccountTable*, AccountIndex*, Journal*, unsigned int);
+
+#endif
@@ -0,0 +1,407 @@
+/* -----------------------------------------------------------------------------
+
+	FILE:              uibench.cpp
+	DESCRIPTION:       Benchmarks the menus. Runs the real screens from menus.cpp on a pseudo-terminal,
+	                   pressing keys from scripts, and times every frame they draw
+	USAGE:             uibench [-d directory] [-a accounts] [-s COLUMNSxLINES] [-r runs] [script ...]
+	                   Makes a text database with that many accounts (100000 by default) in directory (/tmp
+	                   by default) and runs each script on it runs times (20 by default), on a terminal of that
+	                   size (120x40 by default). Prints one line of JSON per script. Without any scripts,
+	                   it runs the ones built in below.
+	                   A script is the screen it starts on (main, account, deposit, transfer or open) and then
+	                   the keys to press, separated by spaces: up down left right pgup pgdn home end enter esc
+	                   tab bs space, ^x for control keys, or anything else to type it a character at a time.
+	                   key*n presses a key n times and # starts a comment. When a script runs out of keys,
+	                   esc is pressed until the screen it started on is left. ^c can't be used, since it quits
+	COMPILER:          Built on g++ with c++11. Has to be linked with -Wl,--wrap=wgetch, see the Makefile
+	Exit Codes:
+		- 0: All good
+		- 1: Bad arguments, or a script that can't be read
+		- 2: The database or the terminal couldn't be set up, or esc didn't get a script out of its screen
+
+----------------------------------------------------------------------------- */
+
+#include <ncurses.h>
+#include <locale.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "bankacct.h"
+#include "generate.h"
+
+//The commit the benchmark was built from, so results can be told apart. The Makefile fills it in
+#ifndef BENCH_COMMIT
+#define BENCH_COMMIT "unknown"
+#endif
+
+//How long the terminal has to stay quiet before a frame's output is taken to be all there
+#define QUIET_MICROS 200
+//How many times esc is pressed for a script that runs out of keys before giving up on it
+#define MAX_EXTRA_ESC 10
+
+using namespace std;
+
+//The screens a script can start on
+enum Screen {
+	SCREEN_MAIN,
+	SCREEN_ACCOUNT,
+	SCREEN_DEPOSIT,
+	SCREEN_TRANSFER,
+	SCREEN_OPEN,
+	SCREEN_COUNT
+};
+
+static const char* screenNames[SCREEN_COUNT] = {"main", "account", "deposit", "transfer", "open"};
+
+//Keys scripts can use by name
+struct KeyName {
+	const char* name;
+	int key;
+};
+
+static const KeyName keyNames[] = {
+	{"up", KEY_UP}, {"down", KEY_DOWN}, {"left", KEY_LEFT}, {"right", KEY_RIGHT},
+	{"pgup", KEY_PPAGE}, {"pgdn", KEY_NPAGE}, {"home", KEY_HOME}, {"end", KEY_END},
+	{"enter", 10}, {"esc", 27}, {"tab", '\t'}, {"bs", KEY_BACKSPACE}, {"space", ' '}
+};
+
+//Run when no scripts are given. Each one backs out at the end, so nothing gets changed
+static const char* builtInScripts[][2] = {
+	{"main-browse", "main down*60 up*20 pgdn*20 pgup*10 end home down*5 esc"},
+	{"main-sort", "main down*10 tab down*10 tab down*10 tab down*10 tab down*10 tab esc"},
+	{"main-find", "main ^f Dav down*5 up*2 bs*3 Mil down*5 enter down*5 esc"},
+	{"account", "account right*8 left*4 esc"},
+	{"deposit", "deposit 1234.56 bs*3 .5 enter esc esc"},
+	{"transfer", "transfer 0 tab*20 bs 1 tab*10 esc"},
+	{"open", "open Jane enter Doe enter Q enter 123456789 enter 775 enter 5551234 enter 100.00 enter esc"}
+};
+
+struct Script {
+	string name;
+	Screen screen;
+	vector<int> keys;
+};
+
+//What the wrapped wgetch() feeds the screens and what it finds out about the frames they draw
+static const vector<int>* keys;
+static size_t nextKey, extraEsc;
+static chrono::steady_clock::time_point frameStart;
+static size_t frameStartBytes;
+static vector<double> frameMicros;
+static vector<size_t> frameBytes;
+//Everything that's come out of the terminal so far
+static atomic<size_t> bytesRead(0);
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readTerminal()
+DESCRIPTION:       Reads everything the screens write to the terminal, counting it, until the terminal is closed
+RETURNS:           Void function
+NOTES:             Runs on its own thread, so the screens never wait for anyone to read what they've drawn
+----------------------------------------------------------------------------- */
+void readTerminal(int master) {
+	char buffer[65536];
+	ssize_t length;
+	while((length = read(master, buffer, sizeof(buffer))) > 0) bytesRead += length;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          waitForQuiet()
+DESCRIPTION:       Waits until nothing more has come out of the terminal for QUIET_MICROS
+RETURNS:           How many bytes have come out of it altogether
+NOTES:             What's written to a pseudo-terminal takes a moment to come out the other side
+----------------------------------------------------------------------------- */
+size_t waitForQuiet() {
+	size_t before;
+	do {
+		before = bytesRead;
+		this_thread::sleep_for(chrono::microseconds(QUIET_MICROS));
+	} while(bytesRead != before);
+	return before;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          __wrap_wgetch()
+DESCRIPTION:       Stands in for wgetch() in the menus. Finishes the frame the screen was drawing, then
+                   gives it the next key of the script instead of waiting for one
+RETURNS:           The key
+NOTES:             A frame is everything between getting a key and asking for the next one, including drawing
+                   it to the terminal, which the real wgetch() would do first too.
+                   The menus check for the rest of an F key's escape sequence without waiting after an ESC.
+                   There never is one, and that doesn't count as a frame
+----------------------------------------------------------------------------- */
+extern "C" int __wrap_wgetch(WINDOW* window) {
+	if(is_nodelay(window)) return ERR;
+	wrefresh(window);
+	frameMicros.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - frameStart).count());
+	size_t bytes = waitForQuiet();
+	frameBytes.push_back(bytes - frameStartBytes);
+
+	int key = 27;
+	if(nextKey < keys->size()) key = (*keys)[nextKey++];
+	else extraEsc++;
+	//Something has gone wrong if esc doesn't get it out. Stop here rather than press keys forever
+	if(extraEsc > MAX_EXTRA_ESC) {
+		endwin();
+		fprintf(stderr, "uibench: a script didn't leave the screen it started on\n");
+		exit(2);
+	}
+	frameStartBytes = bytes;
+	frameStart = chrono::steady_clock::now();
+	return key;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          parseScript()
+DESCRIPTION:       Reads a script's screen and keys out of text
+RETURNS:           true if it's a script, false otherwise
+----------------------------------------------------------------------------- */
+bool parseScript(const string& text, Script* script) {
+	//Comments go first
+	string words;
+	bool comment = false;
+	for(char c : text) {
+		if(c == '#') comment = true;
+		else if(c == '\n') comment = false;
+		words += comment ? ' ' : c;
+	}
+
+	bool haveScreen = false;
+	size_t at = 0;
+	while(true) {
+		at = words.find_first_not_of(" \t\r\n", at);
+		if(at == string::npos) break;
+		size_t end = words.find_first_of(" \t\r\n", at);
+		string word = words.substr(at, end == string::npos ? string::npos : end - at);
+		at = end;
+
+		if(!haveScreen) {
+			int screen = 0;
+			while(screen < SCREEN_COUNT && word != screenNames[screen]) screen++;
+			if(screen == SCREEN_COUNT) return false;
+			script->screen = (Screen) screen;
+			haveScreen = true;
+			continue;
+		}
+
+		unsigned long times = 1;
+		size_t star = word.rfind('*');
+		if(star != string::npos && star > 0 && star + 1 < word.size()) {
+			char* end;
+			times = strtoul(word.c_str() + star + 1, &end, 10);
+			if(*end) return false;
+			word.erase(star);
+		}
+		vector<int> pressed;
+		for(const KeyName& name : keyNames) {
+			if(word == name.name) pressed.push_back(name.key);
+		}
+		if(pressed.empty()) {
+			if(word.size() == 2 && word[0] == '^' && isalpha(word[1])) pressed.push_back(toupper(word[1]) - 'A' + 1);
+			else for(char c : word) pressed.push_back(c);
+		}
+		for(unsigned long i = 0; i < times; i++) script->keys.insert(script->keys.end(), pressed.begin(), pressed.end());
+	}
+	return haveScreen;
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          readScript()
+DESCRIPTION:       Reads a script from the file fileName. It's named after the file
+RETURNS:           true if it was read, false otherwise
+----------------------------------------------------------------------------- */
+bool readScript(const char* fileName, Script* script) {
+	FILE* file = fopen(fileName, "r");
+	if(!file) return false;
+	string text;
+	char buffer[4096];
+	size_t length;
+	while((length = fread(buffer, 1, sizeof(buffer), file)) > 0) text.append(buffer, length);
+	fclose(file);
+	const char* name = strrchr(fileName, '/');
+	script->name = name ? name + 1 : fileName;
+	return parseScript(text, script);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          percentile()
+DESCRIPTION:       Finds the value fraction of the way through sorted
+RETURNS:           The value
+----------------------------------------------------------------------------- */
+double percentile(const vector<double>& sorted, double fraction) {
+	size_t i = sorted.size() * fraction;
+	return sorted[i < sorted.size() ? i : sorted.size() - 1];
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          runScript()
+DESCRIPTION:       Runs script runs times and prints how long its frames took and how much they wrote
+RETURNS:           Void function
+----------------------------------------------------------------------------- */
+void runScript(const Script& script, unsigned int runs, const char* size) {
+	frameMicros.clear();
+	frameBytes.clear();
+	for(unsigned int run = 0; run < runs; run++) {
+		//Every run starts from a blank screen, which isn't timed
+		clear();
+		refresh();
+		frameStartBytes = waitForQuiet();
+		keys = &script.keys;
+		nextKey = 0;
+		extraEsc = 0;
+
+		const AccountTable* people = &store.accounts();
+		//Somewhere in the middle
+		unsigned int row = people->empty() ? 0 : store.order(ORDER_NUMBER).row(people->size() / 2);
+		frameStart = chrono::steady_clock::now();
+		switch(script.screen) {
+			case SCREEN_MAIN:
+				mainMenu(people);
+				break;
+			case SCREEN_ACCOUNT:
+				displayAccount(people, row);
+				break;
+			case SCREEN_DEPOSIT:
+				deposit(people, row);
+				break;
+			case SCREEN_TRANSFER:
+				transferAccount(people, row);
+				break;
+			case SCREEN_OPEN:
+				openAccount(people);
+				break;
+			default:
+				break;
+		}
+	}
+
+	vector<double> sorted = frameMicros;
+	sort(sorted.begin(), sorted.end());
+	double total = 0;
+	for(double micros : sorted) total += micros;
+	size_t bytes = 0;
+	for(size_t frame : frameBytes) bytes += frame;
+	size_t frames = sorted.size();
+	printf("{\"commit\":\"%s\",\"script\":\"%s\",\"screen\":\"%s\",\"records\":%zu,\"terminal\":\"%s\",\"runs\":%u,"
+		"\"frames\":%zu,\"frame_us_mean\":%.1f,\"frame_us_p50\":%.1f,\"frame_us_p99\":%.1f,\"frame_us_max\":%.1f,"
+		"\"bytes\":%zu,\"bytes_per_frame\":%.1f}\n",
+		BENCH_COMMIT, script.name.c_str(), screenNames[script.screen], store.size(), size, runs, frames,
+		frames ? total / frames : 0, frames ? percentile(sorted, 0.5) : 0, frames ? percentile(sorted, 0.99) : 0,
+		frames ? sorted.back() : 0, bytes, frames ? (double) bytes / frames : 0);
+	fflush(stdout);
+}
+
+/* -----------------------------------------------------------------------------
+FUNCTION:          openTerminal()
+DESCRIPTION:       Opens a pseudo-terminal of the given size
+RETURNS:           true if it was opened, false otherwise
+----------------------------------------------------------------------------- */
+bool openTerminal(unsigned short columns, unsigned short lines, int* master, int* slave) {
+	*master = posix_openpt(O_RDWR | O_NOCTTY);
+	if(*master < 0) return false;
+	const char* name;
+	if(grantpt(*master) || unlockpt(*master) || !(name = ptsname(*master)) || (*slave = open(name, O_RDWR | O_NOCTTY)) < 0) {
+		close(*master);
+		return false;
+	}
+	struct winsize size = winsize();
+	size.ws_col = columns;
+	size.ws_row = lines;
+	ioctl(*slave, TIOCSWINSZ, &size);
+	return true;
+}
+
+int main(int argc, char** argv) {
+	string directory = "/tmp";
+	size_t accounts = 100000;
+	unsigned int runs = 20, columns = 120, lines = 40;
+	vector<Script> scripts;
+	for(int i = 1; i < argc; i++) {
+		char* end = nullptr;
+		bool valid = true;
+		if(!strcmp(argv[i], "-d") && i + 1 < argc) directory = argv[++i];
+		else if(!strcmp(argv[i], "-a") && i + 1 < argc) {
+			accounts = strtoull(argv[++i], &end, 10);
+			valid = !*end && accounts && accounts <= UINT32_MAX;
+		} else if(!strcmp(argv[i], "-r") && i + 1 < argc) {
+			runs = strtoul(argv[++i], &end, 10);
+			valid = !*end && runs;
+		} else if(!strcmp(argv[i], "-s") && i + 1 < argc) {
+			valid = sscanf(argv[++i], "%ux%u", &columns, &lines) == 2 && columns && lines && columns < 10000 && lines < 10000;
+		} else if(argv[i][0] == '-') valid = false;
+		else {
+			scripts.push_back(Script());
+			if(!readScript(argv[i], &scripts.back())) {
+				fprintf(stderr, "%s: %s: not a script\n", argv[0], argv[i]);
+				return 1;
+			}
+		}
+		if(!valid) {
+			fprintf(stderr, "Usage: %s [-d directory] [-a accounts] [-s COLUMNSxLINES] [-r runs] [script ...]\n", argv[0]);
+			return 1;
+		}
+	}
+	if(scripts.empty()) {
+		for(auto& builtIn : builtInScripts) {
+			scripts.push_back(Script());
+			scripts.back().name = builtIn[0];
+			parseScript(builtIn[1], &scripts.back());
+		}
+	}
+
+	//Making the database isn't timed
+	string dbName = directory + "/uibench-" + to_string(accounts) + ".db";
+	{
+		AccountTable people;
+		generateAccounts(&people, accounts, GENERATE_SEED);
+		if(!writeTextDatabase(dbName.c_str(), &people)) {
+			fprintf(stderr, "%s: %s: could not be written\n", argv[0], dbName.c_str());
+			return 2;
+		}
+	}
+	char error[STORE_ERROR_LENGTH];
+	store.setSync(JOURNAL_SYNC_ASYNC, JOURNAL_GROUP_BYTES, JOURNAL_ASYNC_MS);
+	if(!store.load(dbName.c_str(), thread::hardware_concurrency(), error) || !store.openJournal(error)) {
+		fprintf(stderr, "%s: %s: %s\n", argv[0], dbName.c_str(), error);
+		return 2;
+	}
+
+	//The same screen bankacct sets up, only on a terminal nobody's looking at
+	int master, slave;
+	if(!openTerminal(columns, lines, &master, &slave)) {
+		fprintf(stderr, "%s: could not open a pseudo-terminal\n", argv[0]);
+		return 2;
+	}
+	thread reader(readTerminal, master);
+	FILE* terminal = fdopen(slave, "r+");
+	setlocale(LC_ALL, "");
+	use_env(FALSE);
+	SCREEN* screen = terminal ? newterm("xterm", terminal, terminal) : nullptr;
+	if(!screen) {
+		fprintf(stderr, "%s: could not start ncurses on the pseudo-terminal\n", argv[0]);
+		return 2;
+	}
+	setupScreen();
+
+	char size[24];
+	snprintf(size, sizeof(size), "%ux%u", columns, lines);
+	for(const Script& script : scripts) runScript(script, runs, size);
+
+	endwin();
+	delscreen(screen);
+	fclose(terminal);
+	reader.join();
+	close(master);
+	store.closeJournal();
+	for(const string& name : {dbName, dbName + JOURNAL_SUFFIX}) unlink(name.c_str());
+	return 0;
+}